@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    BiquadDesign.h
+    Created: 17 Oct 2026 5:12:40pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** b0, b1, b2, a1, a2, already divided by a0. Kept in double so the double cascade
+    runs them as designed, the float one narrows them when it picks them up. */
+using BiquadCoefficients = std::array<double, 5>;
+
+//==============================================================================
+/** The juce::dsp::IIR::Coefficients designs the amp uses, computed straight into
+    a BiquadCoefficients so they can be called from the audio thread without
+    touching the heap. Same formulas as JUCE, worked out in double.
+*/
+struct BiquadDesign
+{
+    static BiquadCoefficients makeHighPass (double sampleRate, double frequency,
+                                            double Q = juce::MathConstants<double>::sqrt2 * 0.5) noexcept
+    {
+        const auto n = std::tan (juce::MathConstants<double>::pi * frequency / sampleRate);
+        const auto nSquared = n * n;
+        const auto invQ = 1.0 / Q;
+        const auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+        return normalise (c1, c1 * -2.0, c1,
+                          1.0, c1 * 2.0 * (nSquared - 1.0), c1 * (1.0 - invQ * n + nSquared));
+    }
+
+    static BiquadCoefficients makeLowShelf (double sampleRate, double cutOffFrequency, double Q, double gainFactor) noexcept
+    {
+        const auto A = juce::jmax (0.0, std::sqrt (gainFactor));
+        const auto aminus1 = A - 1.0;
+        const auto aplus1 = A + 1.0;
+        const auto omega = (juce::MathConstants<double>::twoPi * juce::jmax (cutOffFrequency, 2.0)) / sampleRate;
+        const auto coso = std::cos (omega);
+        const auto beta = std::sin (omega) * std::sqrt (A) / Q;
+        const auto aminus1TimesCoso = aminus1 * coso;
+
+        return normalise (A * (aplus1 - aminus1TimesCoso + beta),
+                          A * 2.0 * (aminus1 - aplus1 * coso),
+                          A * (aplus1 - aminus1TimesCoso - beta),
+                          aplus1 + aminus1TimesCoso + beta,
+                          -2.0 * (aminus1 + aplus1 * coso),
+                          aplus1 + aminus1TimesCoso - beta);
+    }
+
+    static BiquadCoefficients makePeakFilter (double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A = juce::jmax (0.0, std::sqrt (gainFactor));
+        const auto omega = (juce::MathConstants<double>::twoPi * juce::jmax (frequency, 2.0)) / sampleRate;
+        const auto alpha = std::sin (omega) / (Q * 2.0);
+        const auto c2 = -2.0 * std::cos (omega);
+        const auto alphaTimesA = alpha * A;
+        const auto alphaOverA = alpha / A;
+
+        return normalise (1.0 + alphaTimesA, c2, 1.0 - alphaTimesA,
+                          1.0 + alphaOverA, c2, 1.0 - alphaOverA);
+    }
+
+private:
+    static BiquadCoefficients normalise (double b0, double b1, double b2, double a0, double a1, double a2) noexcept
+    {
+        const auto a0inv = 1.0 / a0;
+        return { b0 * a0inv, b1 * a0inv, b2 * a0inv, a1 * a0inv, a2 * a0inv };
+    }
+};
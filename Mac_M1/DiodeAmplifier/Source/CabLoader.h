@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    CabLoader.h
+    Created: 18 Oct 2026 1:12:40am
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "CabImpulse.h"
+#include "CabConvolution.h"
+#include "FoldedCab.h"
+
+//==============================================================================
+/** Loads cab impulses on a background thread, like juce::dsp::Convolution did.
+
+    Anything that needs a new impulse built, a file, a latency or a sample rate,
+    just records what it wants and returns. A thread shared by every instance then
+    decodes, hashes and resamples the impulse, has the convolution tuned and
+    partitioned, and installs the result into the plain and folded cab. Those hand
+    it to the audio thread through their kernel slots. Only the newest request is
+    built, so a burst of changes costs one load, and one that ends up asking for
+    the impulse, rate, latency and block size already installed costs nothing.
+
+    Until a new impulse is ready the cab keeps playing the one it has.
+*/
+class CabLoader : private juce::TimeSliceClient
+{
+public:
+    CabLoader (CabConvolution& convolutionToLoad, FoldedCab& foldedCabToLoad)
+        : convolution (convolutionToLoad), foldedCab (foldedCabToLoad)
+    {
+        loadThread->addTimeSliceClient (this);
+    }
+
+    ~CabLoader() override
+    {
+        loadThread->removeTimeSliceClient (this);
+    }
+
+    /** Any thread. Keeps the impulse playing now if the file can't be read. */
+    void loadFile (const juce::File& file)
+    {
+        {
+            const juce::ScopedLock sl (requestLock);
+            requestedFile = file;
+            requestedData = nullptr;
+            requestedSize = 0;
+        }
+
+        changed();
+    }
+
+    /** Any thread. data has to stay valid for as long as the loader, like BinaryData. */
+    void loadMemory (const void* data, size_t size)
+    {
+        {
+            const juce::ScopedLock sl (requestLock);
+            requestedFile = juce::File();
+            requestedData = data;
+            requestedSize = size;
+        }
+
+        changed();
+    }
+
+    /** Any thread, lock free. 0 or a power of two, see CabConvolution::setLatency(). */
+    void setLatency (int latency) noexcept
+    {
+        if (requestedLatency.exchange (latency) != latency)
+            changed();
+    }
+
+    /** Any thread, lock free. Impulses get built once this has been called, call it after preparing the cabs. */
+    void prepare (const juce::dsp::ProcessSpec& spec) noexcept
+    {
+        // Hosts prepare again on every transport start and bypass, most of the time with nothing different
+        const auto newRate = requestedSampleRate.exchange (spec.sampleRate) != spec.sampleRate;
+        const auto newBlockSize = requestedBlockSize.exchange ((int) spec.maximumBlockSize) != (int) spec.maximumBlockSize;
+        const auto newChannels = requestedChannels.exchange ((int) spec.numChannels) != (int) spec.numChannels;
+
+        if (newRate || newBlockSize || newChannels)
+            changed();
+    }
+
+    /** Any thread. Length of the loaded cab in seconds. */
+    double getTailSeconds() const noexcept
+    {
+        return tailSeconds.load();
+    }
+
+    /** Any thread. True once everything asked for so far is in the cabs, for the audio thread to pick up. */
+    bool isLoaded() const noexcept
+    {
+        return loadedVersion.load() == requestedVersion.load();
+    }
+
+private:
+    struct LoadThread : public juce::TimeSliceThread
+    {
+        LoadThread() : juce::TimeSliceThread ("Cab impulses") { startThread(); }
+        ~LoadThread() override { stopThread (1000); }
+    };
+
+    void changed() noexcept
+    {
+        ++requestedVersion;
+    }
+
+    int useTimeSlice() override
+    {
+        const auto version = requestedVersion.load();
+
+        if (version == builtVersion)
+        {
+            loadedVersion.store (version);
+            return 50;
+        }
+
+        juce::File file;
+        const void* data = nullptr;
+        size_t size = 0;
+
+        {
+            const juce::ScopedLock sl (requestLock);
+            file = requestedFile;
+            data = requestedData;
+            size = requestedSize;
+        }
+
+        builtVersion = version;
+
+        // Hosts restore state on undo and preset recall, the same impulse doesn't need decoding again
+        if (data != nullptr)
+        {
+            if (! impulse.isLoaded (data, size))
+                impulse.loadFromMemory (data, size);
+        }
+        else if (file != juce::File() && ! impulse.isLoaded (file))
+        {
+            impulse.loadFromFile (file);
+        }
+
+        const auto sampleRate = requestedSampleRate.load();
+
+        if (sampleRate <= 0.0)
+            return 0;
+
+        const auto latency = requestedLatency.load();
+        const auto blockSize = requestedBlockSize.load();
+        const auto numChannels = requestedChannels.load();
+
+        // A new rate, block size or channel count needs the impulse built again just like a new impulse does
+        const auto newImpulse = impulse.getKey() != installedKey || sampleRate != installedSampleRate
+                                 || blockSize != installedBlockSize || numChannels != installedChannels;
+        const auto newLatency = latency != installedLatency;
+
+        // Installing the same again would throw away the warm kernels for a crossfade into cold ones
+        if (! newImpulse && ! newLatency)
+            return 0;
+
+        installedKey = impulse.getKey();
+        installedSampleRate = sampleRate;
+        installedLatency = latency;
+        installedBlockSize = blockSize;
+        installedChannels = numChannels;
+
+        if (newLatency)
+        {
+            convolution.setLatency (latency);
+            foldedCab.setLatency (latency);
+        }
+
+        // Resampled here rather than by the convolution so the folded cab gets the exact same impulse
+        auto resampled = impulse.getResampled (sampleRate);
+        tailSeconds.store (resampled->buffer.getNumSamples() / sampleRate);
+
+        if (newImpulse)
+            foldedCab.setCabImpulse (resampled);
+
+        convolution.loadImpulseResponse (resampled->buffer, sampleRate);
+
+        return 0;
+    }
+
+    CabConvolution& convolution;
+    FoldedCab& foldedCab;
+
+    // Loading thread only
+    CabImpulse impulse;
+    int builtVersion = -1;
+
+    // What the cabs were last given, loading thread only
+    juce::String installedKey;
+    double installedSampleRate = 0.0;
+    int installedLatency = -1, installedBlockSize = 0, installedChannels = 0;
+
+    juce::CriticalSection requestLock;
+    juce::File requestedFile;
+    const void* requestedData = nullptr;
+    size_t requestedSize = 0;
+
+    std::atomic<int> requestedVersion { 0 }, loadedVersion { -1 }, requestedLatency { 0 }, requestedBlockSize { 0 }, requestedChannels { 0 };
+    std::atomic<double> requestedSampleRate { 0.0 }, tailSeconds { 0.0 };
+
+    juce::SharedResourcePointer<LoadThread> loadThread;
+
+    JUCE_DECLARE_NON_COPYABLE (CabLoader)
+};
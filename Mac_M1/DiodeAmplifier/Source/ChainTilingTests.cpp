@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+    ChainTilingTests.cpp
+    Created: 18 Oct 2026 12:34:18am
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+// Tests stay out of the shipping plugin, build with JUCE_UNIT_TESTS=1 to run them
+#if JUCE_UNIT_TESTS
+
+#include "PluginProcessor.h"
+
+//==============================================================================
+/** Renders the same input through two processors, one taking each host block whole
+    and one cutting it into tiles, and checks they come out sample for sample the same.
+
+    The drive, the tone and the input level all move along the way, so the drive ramp,
+    the clipper table catching up, the filter ramps and Auto's switches all land inside
+    tiled blocks. The cab runs on every tile too, with its output gain ramp, and with
+    Fold EQ on the tone change unfolds it and a new composite warms up and fades in.
+    Both processors are given their impulses and composites before they're needed,
+    so the background threads can't have one switch over a block before the other.
+*/
+class ChainTilingTests : public juce::UnitTest
+{
+public:
+    ChainTilingTests() : juce::UnitTest ("Chain tiling", "DiodeAmplifier") {}
+
+    void runTest() override
+    {
+        const juce::StringArray clipperModes { "Curve", "Table", "ADAA 1st", "ADAA 2nd" };
+        const juce::StringArray oversamplingChoices { "1x", "2x", "4x", "8x", "Auto" };
+
+        for (auto foldEq : { false, true })
+        {
+            for (auto clipperMode : { 0, 1, 3 })
+            {
+                for (auto oversamplingChoice : { 0, 2, 4 })
+                {
+                    beginTest (clipperModes[clipperMode] + " at " + oversamplingChoices[oversamplingChoice] + (foldEq ? " with Fold EQ" : ""));
+                    expectTilesMatchWholeBlocks (clipperMode, oversamplingChoice, foldEq);
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr int blockSize = 256, numBlocks = 240;
+    static constexpr double sampleRate = 48000.0;
+
+    void expectTilesMatchWholeBlocks (int clipperMode, int oversamplingChoice, bool foldEq)
+    {
+        DiodeAmplifierAudioProcessor whole, tiled;
+        tiled.tileSize = 64;
+
+        // One at a time, so the second finds the head length the first had timed rather than timing its own
+        for (auto* processor : { &whole, &tiled })
+        {
+            setParameter (*processor, cabId, 1.0f);
+            setParameter (*processor, foldEqId, foldEq ? 1.0f : 0.0f);
+            setParameter (*processor, clipperModeId, (float) clipperMode);
+            setParameter (*processor, menuId, (float) oversamplingChoice);
+            setParameter (*processor, driveSliderId, 4.0f);
+            processor->prepareToPlay (sampleRate, blockSize);
+
+            expect (waitForCab (*processor, foldEq), "The cab never loaded");
+        }
+
+        juce::AudioBuffer<float> wholeBuffer (2, blockSize), tiledBuffer (2, blockSize);
+        juce::MidiBuffer midi;
+        auto mismatches = 0;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (auto* processor : { &whole, &tiled })
+            {
+                if (block == 40 || block == 160)
+                    setParameter (*processor, driveSliderId, block == 40 ? 8.0f : 2.0f);
+
+                if (block == 60)
+                    setParameter (*processor, midSliderId, 4.0f);
+            }
+
+            // Loud, then quiet for long enough that Auto steps down, then loud again
+            const auto level = block >= 80 && block < 140 ? 0.01f : 0.8f;
+
+            for (int channel = 0; channel < wholeBuffer.getNumChannels(); ++channel)
+                for (int i = 0; i < blockSize; ++i)
+                    wholeBuffer.setSample (channel, i, level * (float) std::sin (juce::MathConstants<double>::twoPi * 220.0 * (block * blockSize + i) / sampleRate));
+
+            tiledBuffer.makeCopyOf (wholeBuffer);
+            whole.processBlock (wholeBuffer, midi);
+            tiled.processBlock (tiledBuffer, midi);
+
+            for (int channel = 0; channel < wholeBuffer.getNumChannels(); ++channel)
+                for (int i = 0; i < blockSize; ++i)
+                    if (wholeBuffer.getSample (channel, i) != tiledBuffer.getSample (channel, i))
+                        ++mismatches;
+
+            // Both have to have the new table before their drive ramps end, or one would still be on the curve
+            if (clipperMode > 0 && (block == 40 || block == 160))
+            {
+                waitForClipperTable (whole);
+                waitForClipperTable (tiled);
+            }
+
+            // The tone change unfolded both, they have to start warming up the new composite on the same block
+            if (foldEq && block == 60)
+                expect (waitForCab (whole, true) && waitForCab (tiled, true), "No composite for the new tone");
+        }
+
+        expectEquals (mismatches, 0);
+    }
+
+    static void setParameter (DiodeAmplifierAudioProcessor& processor, const char* id, float value)
+    {
+        auto* parameter = processor.treeState.getParameter (id);
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    }
+
+    /** Waits for the impulse to be installed and, if it's folding, a composite for the current tone. */
+    static bool waitForCab (DiodeAmplifierAudioProcessor& processor, bool foldEq)
+    {
+        const auto& foldedCab = processor.foldedCab;
+
+        for (int attempt = 0; attempt < 2000; ++attempt)
+        {
+            if (processor.cabLoader.isLoaded()
+                 && (! foldEq || foldedCab.readyVersion.load() == foldedCab.requestedVersion.load()))
+                return true;
+
+            juce::Thread::sleep (5);
+        }
+
+        return false;
+    }
+
+    static void waitForClipperTable (DiodeAmplifierAudioProcessor& processor)
+    {
+        for (int attempt = 0; attempt < 400; ++attempt)
+        {
+            const auto ready = processor.clipperTables.acquire (processor.driveScaled) != nullptr;
+            processor.clipperTables.release();
+
+            if (ready)
+                return;
+
+            juce::Thread::sleep (5);
+        }
+    }
+};
+
+static ChainTilingTests chainTilingTests;
+
+#endif
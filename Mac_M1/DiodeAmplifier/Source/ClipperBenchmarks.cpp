@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    ClipperBenchmarks.cpp
+    Created: 17 Oct 2026 11:58:20pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+// Tests stay out of the shipping plugin, build with JUCE_UNIT_TESTS=1 to run them
+#if JUCE_UNIT_TESTS
+
+#include "DiodeClipper.h"
+#include "ClipperTable.h"
+#include "AntiderivativeClipper.h"
+
+//==============================================================================
+/** Aliasing and CPU of every clipper mode, next to the curve and the table run through
+    the real juce::dsp::Oversampling at 2x, 4x and 8x with either filter type.
+
+    A sine sitting exactly on an FFT bin goes through each path, so the output is periodic
+    over the analysis window. Everything outside the harmonics of the sine is aliasing,
+    reported in dB against the harmonics along with the time per host rate sample.
+    It takes a few seconds, so it has a category of its own: run it with
+    runTestsInCategory ("DiodeAmplifierBenchmarks") in a release build.
+*/
+class ClipperBenchmarks : public juce::UnitTest
+{
+public:
+    ClipperBenchmarks() : juce::UnitTest ("Clipper aliasing and CPU", "DiodeAmplifierBenchmarks") {}
+
+    void runTest() override
+    {
+        for (auto drive : { 2.0f, 6.0f, 10.0f })
+        {
+            beginTest ("Drive " + juce::String (drive));
+
+            const auto driveScaled = std::pow (10.0f, drive * 0.25f);
+            auto table = std::make_unique<ClipperTable>();
+            table->build (driveScaled);
+
+            const auto curve = [driveScaled] (juce::dsp::AudioBlock<float>& block)
+            {
+                DiodeClipper::process (block.getChannelPointer (0), (int) block.getNumSamples(), driveScaled);
+            };
+
+            const auto lookup = [&table] (juce::dsp::AudioBlock<float>& block)
+            {
+                table->process (block.getChannelPointer (0), (int) block.getNumSamples());
+            };
+
+            const auto curveResult = measure (curve);
+            report ("1x curve", curveResult);
+            report ("1x table", measure (lookup));
+
+            Result antiderivativeResults[2];
+
+            for (int order = 1; order <= 2; ++order)
+            {
+                AntiderivativeClipper clipper;
+                clipper.prepare (1);
+
+                antiderivativeResults[order - 1] = measure ([&] (juce::dsp::AudioBlock<float>& block)
+                {
+                    clipper.process (*table, block.getChannelPointer (0), (int) block.getNumSamples(), 0, order);
+                    clipper.endBlock (*table);
+                });
+
+                report ("1x ADAA " + juce::String (order == 1 ? "1st" : "2nd"), antiderivativeResults[order - 1]);
+            }
+
+            // ADAA should always beat the plain curve at the same rate
+            expectLessThan (antiderivativeResults[1].aliasDecibels, curveResult.aliasDecibels);
+
+            for (auto filterType : { juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
+                                     juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple })
+            {
+                const juce::String filterName (filterType == juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR ? "IIR" : "FIR");
+
+                for (size_t stages = 1; stages <= 3; ++stages)
+                {
+                    const auto name = juce::String (1 << stages) + "x " + filterName;
+                    const auto curveOversampled = measureOversampled (curve, stages, filterType);
+                    report (name + " curve", curveOversampled);
+                    report (name + " table", measureOversampled (lookup, stages, filterType));
+
+                    if (stages == 3)
+                        expectLessThan (curveOversampled.aliasDecibels, curveResult.aliasDecibels);
+                }
+            }
+        }
+    }
+
+private:
+    struct Result
+    {
+        double aliasDecibels = 0.0, nanosecondsPerSample = 0.0;
+    };
+
+    static constexpr int fftOrder = 15, fftSize = 1 << fftOrder;
+    static constexpr int warmUpSamples = 8192, blockSize = 512;
+
+    // Odd, so none of the harmonics folded back over Nyquist lands on another harmonic
+    static constexpr int sineBin = 1663;
+
+    template <typename Clip>
+    Result measureOversampled (Clip& clip, size_t stages, juce::dsp::Oversampling<float>::FilterType filterType)
+    {
+        juce::dsp::Oversampling<float> oversampling (1, stages, filterType);
+        oversampling.initProcessing ((size_t) blockSize);
+
+        return measure ([&] (juce::dsp::AudioBlock<float>& block)
+        {
+            auto upsampledBlock = oversampling.processSamplesUp (block);
+            clip (upsampledBlock);
+            oversampling.processSamplesDown (block);
+        });
+    }
+
+    template <typename Process>
+    Result measure (Process&& process)
+    {
+        juce::AudioBuffer<float> buffer (1, warmUpSamples + fftSize);
+        auto* data = buffer.getWritePointer (0);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            data[i] = 0.5f * (float) std::sin (juce::MathConstants<double>::twoPi * sineBin * i / fftSize);
+
+        juce::dsp::AudioBlock<float> wholeBlock (buffer);
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < buffer.getNumSamples(); i += blockSize)
+        {
+            auto block = wholeBlock.getSubBlock ((size_t) i, (size_t) juce::jmin (blockSize, buffer.getNumSamples() - i));
+            process (block);
+        }
+
+        const auto seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+
+        std::vector<float> spectrum (fftSize * 2, 0.0f);
+        std::copy (data + warmUpSamples, data + warmUpSamples + fftSize, spectrum.begin());
+        juce::dsp::FFT (fftOrder).performFrequencyOnlyForwardTransform (spectrum.data());
+
+        double harmonics = 0.0, aliases = 0.0;
+
+        // DC is left out, the curve isn't symmetric so it always has some
+        for (int bin = 1; bin < fftSize / 2; ++bin)
+        {
+            const auto power = (double) spectrum[(size_t) bin] * spectrum[(size_t) bin];
+            (bin % sineBin == 0 ? harmonics : aliases) += power;
+        }
+
+        Result result;
+        result.aliasDecibels = 10.0 * std::log10 (aliases / harmonics + 1.0e-30);
+        result.nanosecondsPerSample = seconds * 1.0e9 / buffer.getNumSamples();
+        return result;
+    }
+
+    void report (const juce::String& name, const Result& result)
+    {
+        logMessage (name.paddedRight (' ', 18) + juce::String (result.aliasDecibels, 1) + " dB  "
+                    + juce::String (result.nanosecondsPerSample, 1) + " ns/sample");
+    }
+};
+
+static ClipperBenchmarks clipperBenchmarks;
+
+#endif
@@ -0,0 +1,270 @@
+/*
+  ==============================================================================
+
+    ConvolutionTests.cpp
+    Created: 18 Oct 2026 2:06:51pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+// Tests stay out of the shipping plugin, build with JUCE_UNIT_TESTS=1 to run them
+#if JUCE_UNIT_TESTS
+
+#include "CabConvolution.h"
+
+//==============================================================================
+/** Checks the cab convolution against a plain direct form convolution of the same impulse.
+
+    The partitioned tail is run on its own, from an offset and in latency mode, and
+    with the workers held off so the audio thread runs every job itself, or with a
+    job stalled part way through so it works the period out again beside it. Then
+    the whole CabConvolution is run with its FIR head at every length the tuner can
+    pick and at each cab latency. Blocks come in sizes that aren't powers of two,
+    and bigger than the prepared size.
+
+    The reference convolution takes a while, so these have a category of their
+    own, run with runTestsInCategory ("DiodeAmplifierConvolution").
+*/
+class ConvolutionTests : public juce::UnitTest
+{
+public:
+    ConvolutionTests() : juce::UnitTest ("Cab convolution", "DiodeAmplifierConvolution") {}
+
+    void runTest() override
+    {
+        for (auto impulseLength : { 3000, 6000 })
+        {
+            beginTest ("Partitions add up to a " + juce::String (impulseLength) + " sample impulse");
+            expectTailMatches (impulseLength, 256, 0, WorkerMode::running);
+            expectTailMatches (impulseLength, 32, 0, WorkerMode::running);
+
+            beginTest ("Partitions of a " + juce::String (impulseLength) + " sample impulse with latency");
+            expectTailMatches (impulseLength, 0, 256, WorkerMode::running);
+            expectTailMatches (impulseLength, 0, 1024, WorkerMode::running);
+        }
+
+        beginTest ("The audio thread runs jobs no worker got to");
+        expectTailMatches (6000, 256, 0, WorkerMode::heldOff);
+        expectTailMatches (6000, 0, 512, WorkerMode::heldOff);
+
+        beginTest ("The audio thread works a stalled job out again");
+        expectTailMatches (6000, 256, 0, WorkerMode::stalled);
+        expectTailMatches (6000, 0, 512, WorkerMode::stalled);
+
+        for (auto impulseLength : { 100, 1024, 3000, 6000 })
+        {
+            beginTest ("FIR head and tail of a " + juce::String (impulseLength) + " sample impulse");
+
+            for (auto headLength : { 0, 32, 256, 512 })
+                expectCabMatches (impulseLength, impulseLength < 2048 ? 1 : 2, headLength, 0);
+
+            beginTest ("A " + juce::String (impulseLength) + " sample impulse with latency");
+
+            for (auto latency : { 256, 1024 })
+                expectCabMatches (impulseLength, 2, 0, latency);
+        }
+    }
+
+private:
+    enum class WorkerMode { running, heldOff, stalled };
+
+    static constexpr int numChannels = 2, preparedBlockSize = 256, numExtraSamples = 4096;
+    static constexpr double sampleRate = 48000.0;
+    static constexpr float tolerance = 1.0e-3f;
+
+    // Host blocks change size, none of these divide a partition evenly and 700 is over the prepared size
+    static constexpr int blockSizes[] = { 256, 100, 700, 33, 480 };
+
+    //==============================================================================
+    void expectTailMatches (int impulseLength, int offset, int latency, WorkerMode workers)
+    {
+        const auto impulse = makeImpulse (impulseLength, 1);
+        const auto input = makeInput (impulseLength + latency + numExtraSamples);
+        const auto expected = convolveDirect (input, impulse, offset, latency);
+
+        const auto firstSize = latency > 0 ? latency : offset;
+        PartitionedConvolution tail;
+        tail.prepare (PartitionedConvolution::createFilter (impulse, offset, firstSize, latency), numChannels, sampleRate);
+
+        juce::AudioBuffer<float> output (numChannels, input.getNumSamples());
+        output.clear();
+
+        {
+            // With the lock taken for writing no worker can claim anything
+            std::unique_ptr<juce::ScopedWriteLock> holdOff;
+
+            if (workers != WorkerMode::running && tail.workers != nullptr)
+                holdOff = std::make_unique<juce::ScopedWriteLock> ((*tail.workers)->lock);
+
+            expect (workers == WorkerMode::running || holdOff != nullptr, "No background partitions to hold off");
+
+            // The segment whose job is stalled, and where the stall started
+            PartitionedConvolution::Segment* stalledSegment = nullptr;
+            juce::uint32 stalledAt = 0;
+            auto numStalls = 0;
+
+            for (int done = 0, block = 0; done < input.getNumSamples(); ++block)
+            {
+                const auto numSamples = juce::jmin (blockSizes[block % juce::numElementsInArray (blockSizes)], input.getNumSamples() - done);
+                const float* inputPointers[numChannels];
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    inputPointers[channel] = input.getReadPointer (channel, done);
+
+                auto outputBlock = juce::dsp::AudioBlock<float> (output).getSubBlock ((size_t) done, (size_t) numSamples);
+                tail.processAdding (inputPointers, outputBlock);
+                done += numSamples;
+
+                if (workers != WorkerMode::stalled)
+                    continue;
+
+                // Let go once the audio thread has been late for it, well before the segment would drop out
+                if (stalledSegment != nullptr && tail.position - stalledAt >= (juce::uint32) stalledSegment->size)
+                {
+                    stalledSegment->state.store (PartitionedConvolution::finished);
+                    stalledSegment = nullptr;
+                }
+
+                // Claim a queued job like a worker would, then sit on it
+                if (stalledSegment == nullptr)
+                {
+                    for (auto& segment : tail.segments)
+                    {
+                        auto state = (int) PartitionedConvolution::queued;
+
+                        if (segment->background && segment->state.compare_exchange_strong (state, PartitionedConvolution::running))
+                        {
+                            stalledSegment = segment.get();
+                            stalledAt = tail.position;
+                            ++numStalls;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            if (stalledSegment != nullptr)
+                stalledSegment->state.store (PartitionedConvolution::finished);
+
+            if (workers == WorkerMode::stalled)
+                expectGreaterThan (numStalls, 0);
+        }
+
+        expectBuffersMatch (output, expected);
+    }
+
+    void expectCabMatches (int impulseLength, int numImpulseChannels, int headLength, int latency)
+    {
+        const auto impulse = makeImpulse (impulseLength, numImpulseChannels);
+        const auto input = makeInput (impulseLength + latency + numExtraSamples);
+        const auto expected = convolveDirect (input, impulse, 0, latency);
+
+        CabConvolution convolution;
+        convolution.prepare ({ sampleRate, (juce::uint32) preparedBlockSize, (juce::uint32) numChannels });
+
+        if (latency > 0)
+        {
+            convolution.setLatency (latency);
+            convolution.loadImpulseResponse (impulse, sampleRate);
+        }
+        else
+        {
+            convolution.load (impulse, ImpulseStore::hash (impulse), headLength);
+        }
+
+        juce::AudioBuffer<float> output;
+        output.makeCopyOf (input);
+
+        for (int done = 0, block = 0; done < output.getNumSamples(); ++block)
+        {
+            const auto numSamples = juce::jmin (blockSizes[block % juce::numElementsInArray (blockSizes)], output.getNumSamples() - done);
+            auto outputBlock = juce::dsp::AudioBlock<float> (output).getSubBlock ((size_t) done, (size_t) numSamples);
+            convolution.process (juce::dsp::ProcessContextReplacing<float> (outputBlock));
+            done += numSamples;
+        }
+
+        expectEquals (convolution.getLatency(), latency);
+        expectBuffersMatch (output, expected);
+    }
+
+    void expectBuffersMatch (const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& expected)
+    {
+        auto worst = 0.0f;
+        auto worstIndex = 0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            for (int i = 0; i < output.getNumSamples(); ++i)
+            {
+                const auto error = std::abs (output.getSample (channel, i) - expected.getSample (channel, i));
+
+                if (error > worst)
+                {
+                    worst = error;
+                    worstIndex = i;
+                }
+            }
+        }
+
+        expectLessThan (worst, tolerance, "Sample " + juce::String (worstIndex));
+    }
+
+    //==============================================================================
+    /** Decaying noise, about the shape of a cab or a room. */
+    static juce::AudioBuffer<float> makeImpulse (int length, int numImpulseChannels)
+    {
+        juce::AudioBuffer<float> impulse (numImpulseChannels, length);
+        juce::Random random (length);
+
+        for (int channel = 0; channel < numImpulseChannels; ++channel)
+            for (int i = 0; i < length; ++i)
+                impulse.setSample (channel, i, 0.1f * (random.nextFloat() * 2.0f - 1.0f) * std::exp (-4.0f * (float) i / (float) length));
+
+        return impulse;
+    }
+
+    static juce::AudioBuffer<float> makeInput (int length)
+    {
+        juce::AudioBuffer<float> input (numChannels, length);
+        juce::Random random (1);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < length; ++i)
+                input.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+        return input;
+    }
+
+    /** The taps of impulse from offset onwards, delayed by latency samples. A mono impulse runs on every channel. */
+    static juce::AudioBuffer<float> convolveDirect (const juce::AudioBuffer<float>& input, const juce::AudioBuffer<float>& impulse, int offset, int latency)
+    {
+        juce::AudioBuffer<float> output (numChannels, input.getNumSamples());
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* x = input.getReadPointer (channel);
+            const auto* h = impulse.getReadPointer (juce::jmin (channel, impulse.getNumChannels() - 1));
+
+            for (int n = 0; n < input.getNumSamples(); ++n)
+            {
+                double sum = 0.0;
+
+                for (int k = offset; k < impulse.getNumSamples() && k <= n - latency; ++k)
+                    sum += (double) h[k] * (double) x[n - latency - k];
+
+                output.setSample (channel, n, (float) sum);
+            }
+        }
+
+        return output;
+    }
+};
+
+constexpr int ConvolutionTests::blockSizes[];
+
+static ConvolutionTests convolutionTests;
+
+#endif
@@ -0,0 +1,237 @@
+/*
+  ==============================================================================
+
+    DiodeClipper.h
+    Created: 17 Oct 2026 10:12:31am
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** The diode transfer curve, y = 2 / 3.14 * atan ((exp (x * 0.1 / (0.0253 * 1.68)) - 1) * drive * 16).
+
+    process() runs the curve a whole SIMDRegister at a time. exp and atan are
+    replaced with polynomial approximations, the error against the original
+    scalar curve is reported by getMaxDeviation().
+*/
+struct DiodeClipper
+{
+    using Vec = juce::dsp::SIMDRegister<float>;
+    using Mask = Vec::vMaskType;
+
+    static constexpr float piDivisor = 2.0f / 3.14f;
+    static constexpr float diodeScale = 0.1f / (0.0253f * 1.68f);
+
+    // The curve exactly as processBlock used to compute it, kept as the reference
+    static float processSampleReference (float input, float driveScaled) noexcept
+    {
+        const auto diodeClippingAlgorithm = (float) (std::exp ((0.1 * input) / (0.0253 * 1.68)) - 1);
+
+        return piDivisor * std::atan (diodeClippingAlgorithm * (driveScaled * 16));
+    }
+
+    // The curve in double precision with the real exp and atan
+    static double processSampleExact (double input, double driveScaled) noexcept
+    {
+        return (double) piDivisor * std::atan (std::expm1 (input * (double) diodeScale) * driveScaled * 16.0);
+    }
+
+    static Vec processVec (Vec input, Vec gain) noexcept
+    {
+        // Past these limits atan is already flat to within float precision
+        auto x = Vec::min (Vec::max (input * diodeScale, Vec::expand (-20.0f)), Vec::expand (12.0f));
+
+        return approximateAtan (expMinusOne (x) * gain) * piDivisor;
+    }
+
+    /** Clips numSamples of data in place, driveScaled is the 10^(drive / 4) multiplier. */
+    static void process (float* data, int numSamples, float driveScaled) noexcept
+    {
+        const auto gain = Vec::expand (driveScaled * 16.0f);
+        constexpr auto width = (int) Vec::SIMDNumElements;
+
+        // Unaligned head and the tail go through a padded register so every sample sees the same curve
+        auto* aligned = juce::jmin (Vec::getNextSIMDAlignedPtr (data), data + numSamples);
+        processPartial (data, (int) (aligned - data), gain);
+
+        auto numAligned = (int) (numSamples - (aligned - data)) / width * width;
+
+        for (int i = 0; i < numAligned; i += width)
+            processVec (Vec::fromRawArray (aligned + i), gain).copyToRawArray (aligned + i);
+
+        processPartial (aligned + numAligned, (int) (data + numSamples - (aligned + numAligned)), gain);
+    }
+
+    /** Same again with a driveScaled value for every sample, for while the drive knob is moving. */
+    static void process (float* data, const float* driveScaled, int numSamples) noexcept
+    {
+        constexpr auto width = (int) Vec::SIMDNumElements;
+
+        auto* aligned = juce::jmin (Vec::getNextSIMDAlignedPtr (data), data + numSamples);
+        const auto numHead = (int) (aligned - data);
+        processPartial (data, driveScaled, numHead);
+
+        auto numAligned = (numSamples - numHead) / width * width;
+
+        for (int i = 0; i < numAligned; i += width)
+            processVec (Vec::fromRawArray (aligned + i), loadUnaligned (driveScaled + numHead + i) * 16.0f).copyToRawArray (aligned + i);
+
+        processPartial (aligned + numAligned, driveScaled + numHead + numAligned, numSamples - numHead - numAligned);
+    }
+
+    /** The double precision path skips the approximations altogether. */
+    static void process (double* data, int numSamples, double driveScaled) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = processSampleExact (data[i], driveScaled);
+    }
+
+    static void process (double* data, const float* driveScaled, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = processSampleExact (data[i], (double) driveScaled[i]);
+    }
+
+    /** Sweeps the useful input range at every drive step and returns the largest
+        absolute difference between process() and processSampleReference().
+    */
+    static float getMaxDeviation()
+    {
+        constexpr int numPoints = 16000;
+        float maxDeviation = 0.0f;
+
+        for (float drive = 0.0f; drive <= 10.0f; drive += 0.25f)
+        {
+            const auto driveScaled = std::pow (10.0f, drive * 0.25f);
+
+            std::vector<float> input (numPoints), output (numPoints);
+
+            for (int i = 0; i < numPoints; ++i)
+                input[i] = output[i] = -8.0f + 16.0f * (float) i / (float) numPoints;
+
+            process (output.data(), numPoints, driveScaled);
+
+            for (int i = 0; i < numPoints; ++i)
+                maxDeviation = juce::jmax (maxDeviation, std::abs (output[i] - processSampleReference (input[i], driveScaled)));
+        }
+
+        return maxDeviation;
+    }
+
+private:
+    static void processPartial (float* data, int numSamples, Vec gain) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        alignas (Vec::SIMDRegisterSize) float scratch[Vec::SIMDNumElements] {};
+        std::copy (data, data + numSamples, scratch);
+        processVec (Vec::fromRawArray (scratch), gain).copyToRawArray (scratch);
+        std::copy (scratch, scratch + numSamples, data);
+    }
+
+    static void processPartial (float* data, const float* driveScaled, int numSamples) noexcept
+    {
+        if (numSamples <= 0)
+            return;
+
+        alignas (Vec::SIMDRegisterSize) float scratch[Vec::SIMDNumElements] {};
+        alignas (Vec::SIMDRegisterSize) float gains[Vec::SIMDNumElements] {};
+        std::copy (data, data + numSamples, scratch);
+        std::copy (driveScaled, driveScaled + numSamples, gains);
+        processVec (Vec::fromRawArray (scratch), Vec::fromRawArray (gains) * 16.0f).copyToRawArray (scratch);
+        std::copy (scratch, scratch + numSamples, data);
+    }
+
+    // The drive ramp isn't aligned the same way as the audio, the copy compiles to an unaligned load
+    static Vec loadUnaligned (const float* source) noexcept
+    {
+        alignas (Vec::SIMDRegisterSize) float scratch[Vec::SIMDNumElements];
+        std::copy (source, source + Vec::SIMDNumElements, scratch);
+        return Vec::fromRawArray (scratch);
+    }
+
+    // SIMDRegister has no reinterpreting cast, the same union trick it uses internally
+    static Mask toBits (Vec v) noexcept
+    {
+        union { Vec::vSIMDType f; Mask::vSIMDType i; } u;
+        u.f = v.value;
+        return Mask::fromNative (u.i);
+    }
+
+    static Vec fromBits (Mask m) noexcept
+    {
+        return Vec::expand (0.0f) | m;
+    }
+
+    static Vec select (Mask m, Vec a, Vec b) noexcept
+    {
+        return (a & m) + (b & ~m);
+    }
+
+    static Vec floorVec (Vec x) noexcept
+    {
+        auto t = Vec::truncate (x);
+        return t - (Vec::expand (1.0f) & Vec::greaterThan (t, x));
+    }
+
+    /** exp (x) - 1, accurate near zero so the curve doesn't get noisy around the zero crossing.
+        x = n * ln2 + r with |r| <= ln2 / 2, exp (r) - 1 from the Cephes expf polynomial (rel. error ~1e-7).
+    */
+    static Vec expMinusOne (Vec x) noexcept
+    {
+        const auto n = floorVec (x * 1.44269504f + 0.5f);
+        const auto r = x - n * 0.693359375f + n * 2.12194440e-4f;
+
+        auto p = Vec::expand (1.9875691500e-4f);
+        p = Vec::multiplyAdd (Vec::expand (1.3981999507e-3f), p, r);
+        p = Vec::multiplyAdd (Vec::expand (8.3334519073e-3f), p, r);
+        p = Vec::multiplyAdd (Vec::expand (4.1665795894e-2f), p, r);
+        p = Vec::multiplyAdd (Vec::expand (1.6666665459e-1f), p, r);
+        p = Vec::multiplyAdd (Vec::expand (5.0000001201e-1f), p, r);
+        const auto m = Vec::multiplyAdd (r, p, r * r);
+
+        // 2^n built straight into the exponent bits, n is integral so the magic add is exact
+        const auto nBits = toBits (n + 12582912.0f) - Mask::expand (0x4b400000u);
+        const auto scale = fromBits ((nBits + Mask::expand (127u)) * Mask::expand (1u << 23));
+
+        return Vec::multiplyAdd (scale - 1.0f, scale, m);
+    }
+
+    /** atan from Abramowitz & Stegun 4.4.49 (|error| <= 2e-8 on [0, 1]),
+        |x| > 1 folds through atan (x) = pi / 2 - atan (1 / x).
+    */
+    static Vec approximateAtan (Vec x) noexcept
+    {
+        const auto sign = Mask::expand (0x80000000u);
+        const auto signBits = toBits (x) & sign;
+        const auto ax = x & ~sign;
+        const auto isLarge = Vec::greaterThan (ax, Vec::expand (1.0f));
+
+        // Reciprocal from a bit-level guess and three Newton steps, SIMDRegister has no divide
+        auto inv = fromBits (Mask::expand (0x7ef311c3u) - toBits (ax));
+        inv = inv * (Vec::expand (2.0f) - ax * inv);
+        inv = inv * (Vec::expand (2.0f) - ax * inv);
+        inv = inv * (Vec::expand (2.0f) - ax * inv);
+
+        const auto t = select (isLarge, inv, ax);
+        const auto t2 = t * t;
+
+        auto p = Vec::expand (-0.0040540580f);
+        p = Vec::multiplyAdd (Vec::expand (0.0218612288f), p, t2);
+        p = Vec::multiplyAdd (Vec::expand (-0.0559098861f), p, t2);
+        p = Vec::multiplyAdd (Vec::expand (0.0964200441f), p, t2);
+        p = Vec::multiplyAdd (Vec::expand (-0.1390853351f), p, t2);
+        p = Vec::multiplyAdd (Vec::expand (0.1994653599f), p, t2);
+        p = Vec::multiplyAdd (Vec::expand (-0.3332985605f), p, t2);
+        p = Vec::multiplyAdd (Vec::expand (0.9999993329f), p, t2);
+        p = p * t;
+
+        return select (isLarge, Vec::expand (juce::MathConstants<float>::halfPi) - p, p) | signBits;
+    }
+};
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    DiodeClipperTests.cpp
+    Created: 17 Oct 2026 11:42:06pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+// Tests stay out of the shipping plugin, build with JUCE_UNIT_TESTS=1 to run them
+#if JUCE_UNIT_TESTS
+
+#include "DiodeClipper.h"
+
+//==============================================================================
+/** Checks the vectorised diode curve against the scalar one it replaced.
+
+    Registered with every juce::UnitTestRunner in a JUCE_UNIT_TESTS build, run
+    the lot with runTestsInCategory ("DiodeAmplifier").
+*/
+class DiodeClipperTests : public juce::UnitTest
+{
+public:
+    DiodeClipperTests() : juce::UnitTest ("Diode clipper", "DiodeAmplifier") {}
+
+    void runTest() override
+    {
+        beginTest ("SIMD curve tracks the reference");
+        {
+            const auto deviation = DiodeClipper::getMaxDeviation();
+            logMessage ("Max deviation: " + juce::String (deviation));
+            expectLessThan (deviation, 1.0e-5f);
+        }
+
+        beginTest ("Unaligned heads and tails see the same curve");
+        {
+            constexpr int numSamples = 67;
+            std::vector<float> input (numSamples + 3);
+
+            for (size_t i = 0; i < input.size(); ++i)
+                input[i] = -1.0f + 2.0f * (float) i / (float) input.size();
+
+            for (int offset = 0; offset < 3; ++offset)
+            {
+                auto output = input;
+                DiodeClipper::process (output.data() + offset, numSamples, 4.0f);
+
+                for (int i = offset; i < offset + numSamples; ++i)
+                    expectWithinAbsoluteError (output[(size_t) i], DiodeClipper::processSampleReference (input[(size_t) i], 4.0f), 1.0e-5f);
+            }
+        }
+
+        beginTest ("A flat drive ramp matches a fixed drive");
+        {
+            constexpr int numSamples = 100;
+            std::vector<float> fixed (numSamples), ramped (numSamples), drive (numSamples, 10.0f);
+
+            for (int i = 0; i < numSamples; ++i)
+                fixed[(size_t) i] = ramped[(size_t) i] = std::sin ((float) i * 0.1f);
+
+            DiodeClipper::process (fixed.data(), numSamples, 10.0f);
+            DiodeClipper::process (ramped.data(), drive.data(), numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+                expectWithinAbsoluteError (ramped[(size_t) i], fixed[(size_t) i], 1.0e-7f);
+        }
+    }
+};
+
+static DiodeClipperTests diodeClipperTests;
+
+#endif
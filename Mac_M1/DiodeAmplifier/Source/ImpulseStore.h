@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    ImpulseStore.h
+    Created: 17 Oct 2026 9:48:12pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** An impulse response held by the ImpulseStore, decoded or already resampled. */
+struct ImpulseData : public juce::ReferenceCountedObject
+{
+    using Ptr = juce::ReferenceCountedObjectPtr<ImpulseData>;
+
+    // Set when buffer points straight into a file in the ImpulseCache
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+
+    juce::AudioBuffer<float> buffer;
+    double sampleRate = 0.0;
+};
+
+//==============================================================================
+/** Everything built from an impulse response, shared by every instance in the process.
+
+    Objects are looked up by a key made from a hash of what they were built from,
+    so a session full of instances on the same cab decodes, resamples and
+    partitions it once. Whoever uses an object keeps a reference to it, and the
+    store lets go of anything nobody else is holding the next time it is asked.
+
+    Use it through a juce::SharedResourcePointer.
+*/
+class ImpulseStore
+{
+public:
+    /** Loading thread. The object for key, or whatever make() returns if there isn't one yet.
+        make() can return nullptr, that is handed back and not kept.
+    */
+    template <typename ObjectType, typename Make>
+    juce::ReferenceCountedObjectPtr<ObjectType> get (const juce::String& key, Make&& make)
+    {
+        const juce::ScopedLock sl (lock);
+        removeUnused();
+
+        const auto found = objects.find (key);
+
+        if (found != objects.end())
+            return static_cast<ObjectType*> (found->second.get());
+
+        // Built under the lock so two instances asking for the same thing build it once
+        juce::ReferenceCountedObjectPtr<ObjectType> object = make();
+
+        if (object != nullptr)
+            objects[key] = object.get();
+
+        return object;
+    }
+
+    static juce::String hash (const void* data, size_t numBytes)
+    {
+        return juce::MD5 (data, numBytes).toHexString();
+    }
+
+    static juce::String hash (const juce::AudioBuffer<float>& buffer)
+    {
+        juce::MemoryOutputStream stream;
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            stream.write (buffer.getReadPointer (channel), sizeof (float) * (size_t) buffer.getNumSamples());
+
+        return juce::MD5 (stream.getData(), stream.getDataSize()).toHexString()
+                 + "_" + juce::String (buffer.getNumChannels());
+    }
+
+private:
+    void removeUnused()
+    {
+        for (auto it = objects.begin(); it != objects.end();)
+        {
+            if (it->second->getReferenceCount() == 1)
+                it = objects.erase (it);
+            else
+                ++it;
+        }
+    }
+
+    juce::CriticalSection lock;
+    std::map<juce::String, juce::ReferenceCountedObjectPtr<juce::ReferenceCountedObject>> objects;
+};
@@ -115,9 +115,22 @@ DiodeAmplifierAudioProcessorEditor::DiodeAmplifierAudioProcessorEditor (DiodeAmp
     resetIRButton.setColour(0x1000102, juce::Colours::black.brighter(0.1));
     resetIRButton.setColour(0x1000103, juce::Colours::black.brighter(0.1));
     
+    addAndMakeVisible(&mSampleMenu);
+    mSampleMenu.addItemList({"1x", "2x", "4x", "8x", "Auto"}, 1);
+    mSampleMenuAttach = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.treeState, menuId, mSampleMenu);
+    mSampleMenu.setColour(0x1000b00, juce::Colour::fromFloatRGBA(0, 0, 0, 0));
+    mSampleMenu.setColour(0x1000c00, juce::Colours::black.brighter(0.1));
+    mSampleMenu.setColour(0x1000a00, juce::Colours::whitesmoke.darker(1.0));
+    
+    addAndMakeVisible(&oversamplingMeter);
+    oversamplingMeter.setJustificationType(juce::Justification::centred);
+    oversamplingMeter.setColour(0x1000281, juce::Colour::fromFloatRGBA(1, 1, 1, 0.25f));
+    
     setCabButtonProps();
     
     setSize (711, 500);
+    
+    startTimerHz(10);
 }
 
 DiodeAmplifierAudioProcessorEditor::~DiodeAmplifierAudioProcessorEditor()
@@ -189,6 +202,8 @@ void DiodeAmplifierAudioProcessorEditor::resized()
     cabButton.setBounds(brightButton.getX(), brightButton.getY() + brightButton.getHeight(), 72, 32);
     cabToggleButton.setBounds(cabButton.getX(), cabButton.getY() + cabButton.getHeight(), 72, 32);
     resetIRButton.setBounds(cabToggleButton.getX(), cabToggleButton.getY() + cabToggleButton.getHeight(), 72, 32);
+    mSampleMenu.setBounds(resetIRButton.getX(), resetIRButton.getY() + resetIRButton.getHeight(), 72, 32);
+    oversamplingMeter.setBounds(mSampleMenu.getX(), mSampleMenu.getY() + mSampleMenu.getHeight(), 72, 24);
 
     // Window border bounds
         windowBorder.setBounds
@@ -200,3 +215,8 @@ void DiodeAmplifierAudioProcessorEditor::resized()
         );
     
 }
+
+void DiodeAmplifierAudioProcessorEditor::timerCallback()
+{
+    oversamplingMeter.setText("Running " + juce::String(audioProcessor.getCurrentOversamplingFactor()) + "x", juce::dontSendNotification);
+}
@@ -9,6 +9,15 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "DiodeClipper.h"
+#include "ClipperTable.h"
+#include "AntiderivativeClipper.h"
+#include "BiquadCascade.h"
+#include "CabConvolution.h"
+#include "FoldedCab.h"
+#include "CabLoader.h"
+#include "ParameterSnapshot.h"
+#include "SmoothedDrive.h"
 
 #define inputGainSliderId "input"
 #define inputGainSliderName "Input"
@@ -35,12 +44,24 @@
 #define cabName "Cab"
 
 #define menuId "menu"
-#define menuName "Menu"
+#define menuName "Oversampling"
+
+#define oversamplingFilterId "oversamplingFilter"
+#define oversamplingFilterName "Oversampling Filter"
+
+#define clipperModeId "clipper"
+#define clipperModeName "Clipper"
+
+#define foldEqId "foldEq"
+#define foldEqName "Fold EQ"
+
+#define cabLatencyId "cabLatency"
+#define cabLatencyName "Cab Latency"
 
 //==============================================================================
 /**
 */
-class DiodeAmplifierAudioProcessor  : public juce::AudioProcessor, public juce::AudioProcessorValueTreeState::Listener
+class DiodeAmplifierAudioProcessor  : public juce::AudioProcessor, public juce::AudioProcessorValueTreeState::Listener, private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -56,6 +77,8 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -79,11 +102,16 @@ public:
     //==============================================================================
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
-    void updateHighPassFilter(const float &freq);
-    void updatePreClipFilter(const float &freq);
     void updateLowFilter(const float &gain);
     void updateMidFilter(const float &gain);
     void updateHighFilter(const float &gain);
+    
+    // Have an impulse response loaded into the cab in the background, one that can't be read leaves the cab as it was
+    void loadCabImpulse(const juce::File& file);
+    void resetCabImpulse();
+    
+    // The factor the clipper is running at right now, Auto moves it around from block to block
+    int getCurrentOversamplingFactor() const { return currentOversamplingFactor.load(); }
 
     juce::AudioProcessorValueTreeState treeState;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
@@ -93,43 +121,191 @@ public:
     juce::File savedFile, root;
     std::unique_ptr<juce::File> location;
 
-    juce::dsp::Convolution convolutionProcessor{juce::dsp::Convolution::Latency{0}};
+    CabConvolution convolutionProcessor;
 
     
 private:
-    const float piDivisor = 2.0 / 3.14;
-    double lastSampleRate;
+    // The host rate, the one every stage but the clipper runs at
     double projectSampleRate {44100.0};
-    float driveScaled;
-    bool convolutionToggle, oversamplingToggle;
+    float driveScaled {1.0f};
+    SmoothedDrive smoothedDrive;
+    // Read by the host for the tail length, from any thread
+    std::atomic<bool> convolutionToggle {false};
+    
+    // Folds the tone filters into the cab impulse while the tone controls are still
+    bool foldEq {false};
+    FoldedCab foldedCab;
+    
+    // Decodes, tunes and installs cab impulses away from the message and audio threads, declared after the cabs so it goes first
+    CabLoader cabLoader {convolutionProcessor, foldedCab};
+    
+    // The tone filters ring for about this long, the cab for however long its impulse is
+    static constexpr double filterTailSeconds = 0.05;
+    
+    // Silent input samples since the last sound, the chain stops running once its tail has rung out
+    int silentSamples = 0;
+    
+    // Choice index 0 is zero latency, then 256, 512 and 1024 samples, the cab gets rebuilt on the loader's thread
+    void setCabLatency(int choice);
     
-    void setAllSampleRates(float value);
+    // Menu index picks 1x/2x/4x/8x or Auto, filter index picks polyphase IIR or linear phase FIR
+    int oversamplingChoice {0}, oversamplingFilter {0};
+    std::atomic<int> currentOversamplingFactor {1};
+    
+    // 0 computes the diode curve, 1 reads it from clipperTables, 2 and 3 are 1st and 2nd order ADAA
+    int clipperMode {0}, lastClipperMode = -1;
+    ClipperTableBuilder clipperTables;
+    
+    // Settled once per host block in processSamples, so every tile of it clips the same way
+    bool driveRamping = false;
+    const ClipperTable* blockClipperTable = nullptr;
+    
+    AntiderivativeClipper antiderivativeClipper;
+    
+    // What the incoming clipper runs on while Auto switches factor, taken over once it's done
+    AntiderivativeClipper transitionClipper;
+    SmoothedDrive transitionDrive;
+    
+    // Auto warms the new factor up for this long with the old one still playing, then fades over for as long again
+    static constexpr double adaptiveFadeSeconds = 0.005;
+    
+    // How long the level has to stay down before Auto drops to a lower factor
+    static constexpr double adaptiveHoldSeconds = 0.2;
+    
+    // Linear gain of preClipFilter at its centre, the most the pre-clip stage can add
+    static constexpr double preClipPeakGain = 6.0;
+    void updatePreClipFilters();
+    
+    // Order matches the ids handed to parameterSnapshot.attach in the constructor
+    enum ParameterIndex { inputGainIndex, driveIndex, lowIndex, midIndex, highIndex, outputGainIndex,
+        brightIndex, cabIndex, oversamplingIndex, oversamplingFilterIndex, clipperModeIndex, foldEqIndex, numParameterIndices };
+    
+    ParameterSnapshot<ParameterIndex, numParameterIndices> parameterSnapshot;
+    void updateParameters();
     
     /* non user controlled filters. Used to shape the tone of the sim*/
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> highPassFilter;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> preClipFilter;
+    enum PreClipStage { highPassFilter, preClipFilter };
 
-    /*user controlled filters for the amp head*/
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> lowFilter;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> midFilter;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> highFilter;
+    /*user controlled filters for the amp head, then the Fuck 4k filter*/
+    enum ToneStage { lowFilter, midFilter, highFilter, highNotchFilter };
+    void updateToneFilter(ToneStage stage, const BiquadCoefficients& coefficients);
     
-    // Fuck 4k filter
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> highNotchFilter;
-    
-    juce::dsp::Gain<float> inputGainProcessor;
+    // The processors that run at whatever precision the host renders in,
+    // only the one matching isUsingDoublePrecision() gets prepared.
+    // All of it runs at projectSampleRate, the oversamplers take the clipper up and back down
+    template <typename SampleType>
+    struct DspChain
+    {
+        BiquadCascade<SampleType, 2> preClipFilters;
+        BiquadCascade<SampleType, FoldedCab::numToneStages> toneFilters;
+        
+        // Run inside the filter passes next to them rather than as passes of their own
+        juce::SmoothedValue<SampleType> inputGain, outputGain;
         
-    juce::dsp::Gain<float> outputGainProcessor;
+        // 2x, 4x and 8x for each filter type, built in prepareToPlay so switching never allocates
+        std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, 6> oversamplingProcessors;
+        juce::dsp::Oversampling<SampleType>* activeOversamplingProcessor = nullptr;
+        
+        // What Auto keeps between blocks, choices are the menu indices of the factors
+        struct Adaptive
+        {
+            bool running = false;
+            int choice = 0, target = 0, heldChoice = 0, holdSamples = 0;
+            
+            // A new switch only starts on the first tile of a host block, however the block is cut up
+            bool blockStart = false;
+            
+            // The factor being switched to, -1 when there isn't one, and how far into the switch it is
+            int incoming = -1, position = 0;
+            juce::dsp::Oversampling<SampleType>* incomingProcessor = nullptr;
+            juce::AudioBuffer<SampleType> incomingBuffer;
+            
+            // Delays the lower factors to line up with 8x, so the latency never moves. Whole samples only,
+            // interpolating would roll off the top octave and change the tone with the factor. That leaves
+            // them up to half a sample off 8x, which only shows halfway through a crossfade, as a dip of a couple of dB up near 20 kHz
+            juce::dsp::DelayLine<SampleType, juce::dsp::DelayLineInterpolationTypes::None> alignment;
+        } adaptive;
+    };
+    
+    DspChain<float> floatChain;
+    DspChain<double> doubleChain;
+    
+    // Settings go to both chains so switching precision doesn't lose them
+    template <typename Function>
+    void forEachChain(Function&& function) { function(floatChain); function(doubleChain); }
+    
+    template <typename SampleType>
+    void prepareChain(DspChain<SampleType>& chain, const juce::dsp::ProcessSpec& spec);
+    
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer, DspChain<SampleType>& chain);
+    
+    template <typename SampleType>
+    void resetChain(DspChain<SampleType>& chain);
+    
+    // Reports the latency of the current settings, without waiting for processChain to run with them
+    template <typename SampleType>
+    void reportLatency(DspChain<SampleType>& chain);
+    
+    template <typename SampleType>
+    juce::dsp::Oversampling<SampleType>* getReportedOversamplingProcessor(DspChain<SampleType>& chain);
+    
+    template <typename SampleType>
+    juce::dsp::Oversampling<SampleType>* getOversamplingProcessor(DspChain<SampleType>& chain, int choice);
+    
+    template <int mode, typename SampleType>
+    void processClipper(juce::dsp::AudioBlock<SampleType>& block, int factor, AntiderivativeClipper& clipper, SmoothedDrive& drive);
+    
+    template <int mode, typename SampleType>
+    void processClipperAt(juce::dsp::AudioBlock<SampleType>& block, juce::dsp::Oversampling<SampleType>* oversamplingProcessor,
+                          AntiderivativeClipper& clipper, SmoothedDrive& drive);
     
-    juce::dsp::Oversampling<float> oversamplingProcessor;
+    template <typename SampleType>
+    void updateAdaptiveTarget(DspChain<SampleType>& chain, SampleType peak, int numSamples);
+    
+    template <int mode, typename SampleType>
+    void processAdaptiveClipper(juce::dsp::AudioBlock<SampleType>& block, DspChain<SampleType>& chain);
+    
+    // A stereo tile at 8x in double is 32 kB, about what a core keeps in L1
+    static constexpr size_t maxTileSize = 256;
+    
+   #if JUCE_UNIT_TESTS
+    // Only ever made smaller, by the tests checking tiles add up to the untiled block
+    size_t tileSize = maxTileSize;
+    friend class ChainTilingTests;
+   #else
+    static constexpr size_t tileSize = maxTileSize;
+   #endif
+    
+    // One processChain per oversampling choice, clipper mode and cab on or off
+    static constexpr int numOversamplingChoices = 5, autoOversamplingChoice = 4, numClipperModes = 4;
+    static constexpr int numChainVariants = numOversamplingChoices * numClipperModes * 2;
+    
+    template <typename SampleType, int variant>
+    void processChain(juce::dsp::AudioBlock<SampleType>& block, DspChain<SampleType>& chain);
+    
+    template <typename SampleType>
+    using ChainVariant = void (DiodeAmplifierAudioProcessor::*)(juce::dsp::AudioBlock<SampleType>&, DspChain<SampleType>&);
+    
+    template <typename SampleType, int... variants>
+    static constexpr std::array<ChainVariant<SampleType>, sizeof...(variants)> makeChainVariants(std::integer_sequence<int, variants...>)
+    {
+        return {{ &DiodeAmplifierAudioProcessor::processChain<SampleType, variants>... }};
+    }
+    
+    void updateLatency(double oversamplingLatency, int factor);
     
 
     juce::AlertWindow settingsDialog {"Settings Window",
             "Congrats, you opened the window, but it doesn't do anything", juce::AlertWindow::AlertIconType::InfoIcon};
     
-    // Parameter listener function
+    // Parameter listener function, only the cab toggle and the cab latency use it
     void parameterChanged (const juce::String& parameterID, float newValue) override;
     
+    // Message thread, swaps the output gain for the cab switch. Which way it went last, so a quick there and back is no swap
+    void handleAsyncUpdate() override;
+    std::atomic<bool> outputGainCabOn {true};
+    
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DiodeAmplifierAudioProcessor)
 };
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    SmoothedDrive.h
+    Created: 17 Oct 2026 6:20:14pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** The clipper's drive multiplier, ramped instead of jumping when the knob moves.
+
+    The ramp is exponential, i.e. a straight line in the knob's dB-like scale.
+    It is timed at the host rate but written out a block at a time at whatever
+    rate the clipper is running, so the oversampled clipper gets a value per sample.
+*/
+class SmoothedDrive
+{
+public:
+    static constexpr double rampSeconds = 0.05;
+
+    void prepare (double sampleRate, int maxClipperBlockSize)
+    {
+        rampLength = juce::jmax (1, juce::roundToInt (sampleRate * rampSeconds));
+        ramp.assign ((size_t) maxClipperBlockSize, 1.0f);
+        countdown = 0;
+    }
+
+    void setCurrentAndTargetValue (float driveScaled) noexcept
+    {
+        current = target = driveScaled;
+        countdown = 0;
+    }
+
+    void setTargetValue (float driveScaled) noexcept
+    {
+        if (driveScaled == target)
+            return;
+
+        target = driveScaled;
+        countdown = rampLength;
+        step = std::log ((double) target / current) / (double) rampLength;
+    }
+
+    bool isSmoothing() const noexcept
+    {
+        return countdown > 0;
+    }
+
+    /** Picks up other's ramp where it is, so a second clipper running alongside gets the same drive. */
+    void follow (const SmoothedDrive& other) noexcept
+    {
+        current = other.current;
+        step = other.step;
+        target = other.target;
+        countdown = other.countdown;
+    }
+
+    /** The drive for every sample of a host block of numHostSamples, oversampled by factor. */
+    const float* getNextBlock (int numHostSamples, int factor) noexcept
+    {
+        const auto numSamples = numHostSamples * factor;
+        jassert ((size_t) numSamples <= ramp.size());
+
+        const auto numSteps = juce::jmin (countdown, numHostSamples) * factor;
+        const auto ratio = std::exp (step / (double) factor);
+
+        for (int i = 0; i < numSteps; ++i)
+        {
+            current *= ratio;
+            ramp[(size_t) i] = (float) current;
+        }
+
+        countdown -= numSteps / factor;
+
+        // Land exactly on the target rather than wherever the repeated multiply ended up
+        if (countdown == 0)
+            current = target;
+
+        std::fill (ramp.begin() + numSteps, ramp.begin() + numSamples, (float) current);
+        return ramp.data();
+    }
+
+private:
+    std::vector<float> ramp;
+    double current = 1.0, step = 0.0;
+    float target = 1.0f;
+    int rampLength = 1, countdown = 0;
+};
@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026 9:14:52am
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Runs the plugin's unit tests, which only get compiled in with JUCE_UNIT_TESTS=1 as this project sets it.
+
+    With no arguments every category below runs, otherwise only the ones named.
+    The convolution tests check the cab against a direct form reference, the
+    benchmarks log aliasing and timings for each drive as they go.
+    Exits with 1 if any test failed, so a build script can stop on it.
+*/
+int main (int argc, char* argv[])
+{
+    // Anything that needs a message thread finds one, like it would in a host
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray categories { "DiodeAmplifier", "DiodeAmplifierConvolution", "DiodeAmplifierBenchmarks" };
+
+    if (argc > 1)
+        categories = juce::StringArray (argv + 1, argc - 1);
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure (false);
+
+    for (const auto& category : categories)
+        runner.runTestsInCategory (category);
+
+    auto failures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        failures += runner.getResult (i)->failures;
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+    AntiderivativeClipper.h
+    Created: 17 Oct 2026 1:58:47pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ClipperTable.h"
+
+//==============================================================================
+/** Antiderivative anti-aliasing (ADAA) for the diode curve.
+
+    First order outputs the slope of the first antiderivative between the last two
+    inputs, second order the matching divided difference of the second antiderivative
+    (Bilbao, Esqueda, Parker, Valimaki 2017). The antiderivatives come from the
+    ClipperTable built for the current drive.
+
+    First order delays the signal by half a sample, second order by one.
+*/
+class AntiderivativeClipper
+{
+public:
+    void prepare (int numChannels)
+    {
+        states.resize ((size_t) numChannels);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& state : states)
+            state = {};
+
+        lastTable = nullptr;
+    }
+
+    /** Clips one channel in place. order is 1 or 2. */
+    template <typename SampleType>
+    void process (const ClipperTable& table, SampleType* data, int numSamples, int channel, int order) noexcept
+    {
+        auto& state = states[(size_t) channel];
+
+        // A new table means a new drive, the cached antiderivatives belong to the old curve
+        if (&table != lastTable)
+            refreshCachedValues (table);
+
+        if (order == 1)
+            processFirstOrder (table, state, data, numSamples);
+        else
+            processSecondOrder (table, state, data, numSamples);
+    }
+
+    /** Keeps the history up to date while the channel is clipped some other way, so coming
+        back to ADAA doesn't difference against stale inputs. Call with the input before clipping.
+    */
+    template <typename SampleType>
+    void skip (const SampleType* input, int numSamples, int channel) noexcept
+    {
+        auto& state = states[(size_t) channel];
+
+        for (int i = juce::jmax (0, numSamples - 2); i < numSamples; ++i)
+        {
+            state.x2 = state.x1;
+            state.x1 = (double) input[i];
+        }
+
+        // The cached antiderivatives belong to the old inputs
+        lastTable = nullptr;
+    }
+
+    /** Must be called once per block after every channel has been processed. */
+    void endBlock (const ClipperTable& table) noexcept
+    {
+        lastTable = &table;
+    }
+
+private:
+    struct State
+    {
+        double x1 = 0.0, x2 = 0.0;
+        double first1 = 0.0, second1 = 0.0;
+        double difference1 = 0.0;
+    };
+
+    static constexpr double tolerance = 1.0e-5;
+
+    void refreshCachedValues (const ClipperTable& table) noexcept
+    {
+        for (auto& state : states)
+        {
+            table.getAntiderivatives (state.x1, state.first1, state.second1);
+            state.difference1 = getDifference (table, state.x1, state.x2, state.second1);
+        }
+    }
+
+    // (F2 (a) - F2 (b)) / (a - b), falling back to F1 at the midpoint when a and b are too close
+    static double getDifference (const ClipperTable& table, double a, double b, double secondA) noexcept
+    {
+        double first, second;
+
+        if (std::abs (a - b) < tolerance)
+        {
+            table.getAntiderivatives ((a + b) * 0.5, first, second);
+            return first;
+        }
+
+        table.getAntiderivatives (b, first, second);
+        return (secondA - second) / (a - b);
+    }
+
+    template <typename SampleType>
+    static void processFirstOrder (const ClipperTable& table, State& state, SampleType* data, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto x = (double) data[i];
+            const auto dx = x - state.x1;
+
+            double first, second;
+            table.getAntiderivatives (x, first, second);
+
+            if (std::abs (dx) < tolerance)
+                data[i] = (SampleType) table.processSample ((float) ((x + state.x1) * 0.5));
+            else
+                data[i] = (SampleType) ((first - state.first1) / dx);
+
+            state.x2 = state.x1;
+            state.x1 = x;
+            state.first1 = first;
+            state.second1 = second;
+        }
+    }
+
+    template <typename SampleType>
+    static void processSecondOrder (const ClipperTable& table, State& state, SampleType* data, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto x = (double) data[i];
+
+            double first, second;
+            table.getAntiderivatives (x, first, second);
+
+            const auto difference = std::abs (x - state.x1) < tolerance
+                                  ? getDifference (table, x, state.x1, second)
+                                  : (second - state.second1) / (x - state.x1);
+
+            const auto span = x - state.x2;
+
+            if (std::abs (span) < tolerance)
+            {
+                const auto mid = (x + state.x2) * 0.5;
+                const auto delta = mid - state.x1;
+
+                if (std::abs (delta) < tolerance)
+                {
+                    data[i] = (SampleType) table.processSample ((float) ((mid + state.x1) * 0.5));
+                }
+                else
+                {
+                    double firstMid, secondMid;
+                    table.getAntiderivatives (mid, firstMid, secondMid);
+                    data[i] = (SampleType) (2.0 / delta * (firstMid + (state.second1 - secondMid) / delta));
+                }
+            }
+            else
+            {
+                data[i] = (SampleType) (2.0 * (difference - state.difference1) / span);
+            }
+
+            state.x2 = state.x1;
+            state.x1 = x;
+            state.first1 = first;
+            state.second1 = second;
+            state.difference1 = difference;
+        }
+    }
+
+    std::vector<State> states;
+    const ClipperTable* lastTable = nullptr;
+};
@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+
+    BiquadCascade.h
+    Created: 17 Oct 2026 3:21:10pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BiquadDesign.h"
+
+//==============================================================================
+/** A fixed chain of biquads run in a single pass over the block.
+
+    Coefficients and state are kept per stage in separate arrays, and the
+    channels sit side by side in the lanes of a SIMDRegister, so each sample
+    goes through every stage for both channels at once. Transposed direct form II.
+
+    New coefficients go through a lock-free triple buffer and are picked up at the
+    start of the next block, so any thread can set them without tearing a stage.
+    The coefficients then slide linearly to the new ones over that block, which stays
+    stable since the stable region of a1, a2 is convex. A block that arrives in pieces
+    is announced with beginBlock(), and is then filtered exactly as if it came whole.
+
+    A stage whose numerator equals its denominator, like a shelf or peak at 0 dB,
+    passes its input straight through once its state has died away, so it is left
+    out of the pass until its coefficients change again. Coming back in it starts
+    from identity coefficients and empty state, which is exactly where it would
+    have been had it kept running, and the usual ramp takes it to the new ones.
+*/
+template <typename SampleType, size_t numStages>
+class BiquadCascade
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    BiquadCascade()
+    {
+        // Every stage starts out as a pass-through
+        writerSet.fill ({ 1.0, 0.0, 0.0, 0.0, 0.0 });
+        sets.fill (writerSet);
+        applyCoefficients (writerSet);
+
+        reset();
+    }
+
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        jassert (spec.numChannels <= Vec::SIMDNumElements);
+
+        interleaved.assign (spec.maximumBlockSize, Vec::expand (0));
+
+        // Whatever was set before playback starts is there from the first sample, not ramped in
+        if ((middle.load() & newBit) != 0)
+            frontIndex = middle.exchange (frontIndex) & indexMask;
+
+        applyCoefficients (sets[(size_t) frontIndex]);
+        rampRemaining = 0;
+        blockRemaining = 0;
+        nextBlockLength = 0;
+        reset();
+    }
+
+    /** Audio thread. The next numSamples make up one block, however many process() calls they
+        come in. New coefficients and which stages run are settled once for all of them.
+    */
+    void beginBlock (size_t numSamples) noexcept
+    {
+        nextBlockLength = numSamples;
+        blockRemaining = 0;
+    }
+
+    void reset() noexcept
+    {
+        s1.fill (Vec::expand (0));
+        s2.fill (Vec::expand (0));
+    }
+
+    /** Any thread. Takes effect at the start of the next block. */
+    void setCoefficients (size_t stage, const BiquadCoefficients& coefficients) noexcept
+    {
+        const juce::SpinLock::ScopedLockType sl (writerLock);
+
+        writerSet[stage] = coefficients;
+        sets[(size_t) backIndex] = writerSet;
+        backIndex = middle.exchange (backIndex | newBit) & indexMask;
+    }
+
+    using Gain = juce::SmoothedValue<SampleType>;
+
+    void process (const juce::dsp::ProcessContextReplacing<SampleType>& context) noexcept
+    {
+        process (context, nullptr, nullptr);
+    }
+
+    /** Also ramps the samples going in through inputGain and the ones coming out through
+        outputGain, in the same pass as the filters. Either can be nullptr.
+    */
+    void process (const juce::dsp::ProcessContextReplacing<SampleType>& context, Gain* inputGain, Gain* outputGain) noexcept
+    {
+        auto& block = context.getOutputBlock();
+        const auto numChannels = block.getNumChannels();
+        const auto numSamples = block.getNumSamples();
+
+        // Without a beginBlock() this call is a block of its own
+        if (blockRemaining == 0)
+            startBlock (nextBlockLength > 0 ? nextBlockLength : numSamples);
+
+        blockRemaining -= juce::jmin (numSamples, blockRemaining);
+
+        const auto numRampSamples = juce::jmin (numSamples, rampRemaining);
+        const auto ramping = numRampSamples > 0;
+        rampRemaining -= numRampSamples;
+
+        const auto& target = sets[(size_t) frontIndex];
+
+        if (numActive == 0 && inputGain == nullptr && outputGain == nullptr)
+        {
+            if (ramping && rampRemaining == 0)
+                applyCoefficients (target);
+
+            return;
+        }
+
+        jassert (numSamples <= interleaved.size());
+
+        auto* lanes = reinterpret_cast<SampleType*> (interleaved.data());
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* data = block.getChannelPointer (channel);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                lanes[i * Vec::SIMDNumElements + channel] = data[i];
+        }
+
+        if (inputGain != nullptr && outputGain != nullptr)
+            filter<true, true> (numSamples, numRampSamples, inputGain, outputGain);
+        else if (inputGain != nullptr)
+            filter<true, false> (numSamples, numRampSamples, inputGain, outputGain);
+        else if (outputGain != nullptr)
+            filter<false, true> (numSamples, numRampSamples, inputGain, outputGain);
+        else
+            filter<false, false> (numSamples, numRampSamples, inputGain, outputGain);
+
+        // Finish exactly on the new set, not on the accumulated steps
+        if (ramping && rampRemaining == 0)
+            applyCoefficients (target);
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            auto* data = block.getChannelPointer (channel);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                data[i] = lanes[i * Vec::SIMDNumElements + channel];
+        }
+    }
+
+private:
+    using CoefficientSet = std::array<BiquadCoefficients, numStages>;
+
+    void startBlock (size_t numSamples) noexcept
+    {
+        nextBlockLength = 0;
+        blockRemaining = numSamples;
+
+        // A ramp still running from an earlier block finishes before the next set is taken
+        if (rampRemaining == 0 && (middle.load() & newBit) != 0)
+        {
+            frontIndex = middle.exchange (frontIndex) & indexMask;
+            rampRemaining = numSamples;
+
+            if (rampRemaining > 0)
+                startRamp (sets[(size_t) frontIndex], rampRemaining);
+            else
+                applyCoefficients (sets[(size_t) frontIndex]);
+        }
+
+        const auto& target = sets[(size_t) frontIndex];
+        const auto ramping = rampRemaining > 0;
+        numActive = 0;
+
+        for (size_t stage = 0; stage < numStages; ++stage)
+        {
+            if (isIdentity (applied[stage]) && (! ramping || isIdentity (target[stage])) && hasSettled (stage))
+            {
+                s1[stage] = Vec::expand (0);
+                s2[stage] = Vec::expand (0);
+            }
+            else
+            {
+                activeStages[numActive++] = stage;
+            }
+        }
+    }
+
+    template <bool withInputGain, bool withOutputGain>
+    void filter (size_t numSamples, size_t numRampSamples, Gain* inputGain, Gain* outputGain) noexcept
+    {
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            auto x = interleaved[i];
+
+            if (withInputGain)
+                x = x * Vec::expand (inputGain->getNextValue());
+
+            for (size_t n = 0; n < numActive; ++n)
+            {
+                const auto stage = activeStages[n];
+                const auto y = b0[stage] * x + s1[stage];
+                s1[stage] = b1[stage] * x - a1[stage] * y + s2[stage];
+                s2[stage] = b2[stage] * x - a2[stage] * y;
+                x = y;
+            }
+
+            if (withOutputGain)
+                x = x * Vec::expand (outputGain->getNextValue());
+
+            interleaved[i] = x;
+
+            if (i < numRampSamples)
+            {
+                for (size_t n = 0; n < numActive; ++n)
+                {
+                    const auto stage = activeStages[n];
+                    b0[stage] += db0[stage];
+                    b1[stage] += db1[stage];
+                    b2[stage] += db2[stage];
+                    a1[stage] += da1[stage];
+                    a2[stage] += da2[stage];
+                }
+            }
+        }
+    }
+
+    void applyCoefficients (const CoefficientSet& set) noexcept
+    {
+        applied = set;
+
+        for (size_t stage = 0; stage < numStages; ++stage)
+        {
+            b0[stage] = Vec::expand ((SampleType) set[stage][0]);
+            b1[stage] = Vec::expand ((SampleType) set[stage][1]);
+            b2[stage] = Vec::expand ((SampleType) set[stage][2]);
+            a1[stage] = Vec::expand ((SampleType) set[stage][3]);
+            a2[stage] = Vec::expand ((SampleType) set[stage][4]);
+        }
+    }
+
+    static bool isIdentity (const BiquadCoefficients& c) noexcept
+    {
+        return std::abs (c[0] - 1.0) < 1.0e-6 && c[1] == c[3] && c[2] == c[4];
+    }
+
+    /** True once the stage's state is under -160 dB, nothing it could add is audible. */
+    bool hasSettled (size_t stage) const noexcept
+    {
+        for (size_t lane = 0; lane < Vec::SIMDNumElements; ++lane)
+            if (std::abs (s1[stage].get (lane)) > (SampleType) 1.0e-8 || std::abs (s2[stage].get (lane)) > (SampleType) 1.0e-8)
+                return false;
+
+        return true;
+    }
+
+    void startRamp (const CoefficientSet& set, size_t numSamples) noexcept
+    {
+        const auto scale = (SampleType) 1 / (SampleType) numSamples;
+
+        for (size_t stage = 0; stage < numStages; ++stage)
+        {
+            db0[stage] = Vec::expand ((SampleType) (set[stage][0] - applied[stage][0]) * scale);
+            db1[stage] = Vec::expand ((SampleType) (set[stage][1] - applied[stage][1]) * scale);
+            db2[stage] = Vec::expand ((SampleType) (set[stage][2] - applied[stage][2]) * scale);
+            da1[stage] = Vec::expand ((SampleType) (set[stage][3] - applied[stage][3]) * scale);
+            da2[stage] = Vec::expand ((SampleType) (set[stage][4] - applied[stage][4]) * scale);
+        }
+    }
+
+    std::array<Vec, numStages> b0, b1, b2, a1, a2, s1, s2;
+    std::array<Vec, numStages> db0, db1, db2, da1, da2;
+    CoefficientSet applied;
+    size_t rampRemaining = 0;
+
+    // The stages left out are picked when a block starts and stay out until the next one
+    std::array<size_t, numStages> activeStages;
+    size_t numActive = 0, blockRemaining = 0, nextBlockLength = 0;
+
+    // Writers fill the back set and swap it with the middle one, the audio thread
+    // swaps its front set with the middle one whenever the new bit is set
+    static constexpr int indexMask = 3, newBit = 4;
+    std::array<CoefficientSet, 3> sets;
+    CoefficientSet writerSet;
+    int backIndex = 1, frontIndex = 0;
+    std::atomic<int> middle { 2 };
+    juce::SpinLock writerLock;
+
+    std::vector<Vec> interleaved;
+};
@@ -32,7 +32,7 @@ void DiodeAmplifierAudioProcessorEditor::setCabButtonProps()
 
                 audioProcessor.root = audioProcessor.savedFile.getParentDirectory().getFullPathName();
 
-                audioProcessor.convolutionProcessor.loadImpulseResponse(audioProcessor.savedFile, juce::dsp::Convolution::Stereo::yes, juce::dsp::Convolution::Trim::yes, 0);
+                audioProcessor.loadCabImpulse(audioProcessor.savedFile);
                         
                 DBG(audioProcessor.savedFile.getFullPathName());
             }
@@ -53,12 +53,7 @@ void DiodeAmplifierAudioProcessorEditor::setCabButtonProps()
     
     resetIRButton.onClick = [&]()
     {
-        audioProcessor.convolutionProcessor.loadImpulseResponse
-        (BinaryData::metalOne_wav,
-         BinaryData::metalOne_wavSize,
-         juce::dsp::Convolution::Stereo::yes,
-         juce::dsp::Convolution::Trim::yes, 0,
-         juce::dsp::Convolution::Normalise::yes);
+        audioProcessor.resetCabImpulse();
         
         audioProcessor.variableTree.setProperty("file", "/source/metalOne.wav", nullptr);
     };
@@ -0,0 +1,491 @@
+/*
+  ==============================================================================
+
+    CabConvolution.h
+    Created: 17 Oct 2026 7:42:18pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PartitionedConvolution.h"
+#include "ConvolutionTuner.h"
+#include "ImpulseStore.h"
+
+//==============================================================================
+/** The cab convolution, picking its engine from the length of the impulse.
+
+    Impulses up to maxDirectLength taps run as a plain FIR in the time domain, a
+    SIMDRegister of taps at a time. That has no latency and no FFT overhead at
+    any block size. Longer ones keep a short head in the FIR and hand the rest
+    to a PartitionedConvolution. Which of those an impulse gets, and how long the
+    head is, comes from a ConvolutionTuner that times them at the prepared block size.
+
+    New impulses are built on the loading thread into one of four kernel slots
+    and picked up at the start of the next block, the same way as the clipper
+    tables. The outputs of the old and new kernels are then crossfaded, or dipped
+    through silence when their latencies differ, since the same audio at two
+    delays would flam. The taps
+    and tail spectra a kernel runs are kept in the ImpulseStore, so instances
+    loading the same impulse the same way share them and only keep their own
+    history and delay lines.
+*/
+class CabConvolution
+{
+public:
+    // The longest impulse the FIR will take on its own, the tuner decides if it should
+    static constexpr int maxDirectLength = 1024;
+
+    /** Impulses loaded after this are tuned for spec's block size. */
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        maxBlockSize = (int) spec.maximumBlockSize;
+        history.assign (spec.numChannels, std::vector<Vec> ((size_t) (historyLength + maxBlockSize) / width + 3, Vec::expand (0.0f)));
+        inputPointers.assign (spec.numChannels, nullptr);
+        fadeBuffer.setSize ((int) spec.numChannels, maxBlockSize);
+
+        preparedBlockSize.store (maxBlockSize);
+        preparedSampleRate.store (spec.sampleRate);
+        preparedChannels.store ((int) spec.numChannels);
+
+        mix.reset (spec.sampleRate, 0.05);
+        mix.setCurrentAndTargetValue (1.0f);
+        reset();
+    }
+
+    /** Impulses loaded after this run with latency samples of delay, 0 or a power of two.
+        With some latency to play with the FIR head goes and the whole impulse runs
+        in FFT partitions of that size, which costs a lot less for long impulses.
+    */
+    void setLatency (int latency) noexcept
+    {
+        jassert (latency == 0 || juce::isPowerOfTwo (latency));
+        requestedLatency.store (latency);
+    }
+
+    /** Audio thread. The delay of the impulse currently playing. */
+    int getLatency() const noexcept
+    {
+        // The outgoing kernel is still the one heard until the dip reaches silence
+        if (ducking && previous != nullptr && mix.getCurrentValue() < 0.5f)
+            return previous->filter->latency;
+
+        return active != nullptr ? active->filter->latency : 0;
+    }
+
+    void reset() noexcept
+    {
+        for (auto& channel : history)
+            std::fill (channel.begin(), channel.end(), Vec::expand (0.0f));
+
+        if (active != nullptr) active->tail.reset();
+        if (previous != nullptr) previous->tail.reset();
+    }
+
+    /** Audio thread. Switches to the newest kernel straight away, for while nothing is playing through it. */
+    void takeLatestKernel() noexcept
+    {
+        finishCrossfade();
+        updateKernel();
+        finishCrossfade();
+    }
+
+    /** Loading thread. The impulse must already be at sampleRate, it is used as is. */
+    void loadImpulseResponse (const juce::AudioBuffer<float>& impulse, double sampleRate)
+    {
+        const juce::ScopedLock sl (loadLock);
+
+        const juce::dsp::ProcessSpec spec { juce::jmax (sampleRate, 1.0),
+                                            (juce::uint32) juce::jmax (1, preparedBlockSize.load()),
+                                            (juce::uint32) juce::jmax (1, preparedChannels.load()) };
+
+        const auto key = ImpulseStore::hash (impulse);
+        const auto latency = requestedLatency.load();
+
+        if (latency > 0)
+        {
+            loadWithLatency (impulse, key, latency);
+            return;
+        }
+
+        const auto headLength = tuner->getHeadLength (impulse.getNumSamples(), (int) spec.numChannels, (int) spec.maximumBlockSize, maxDirectLength,
+                                                      [&impulse, &key, &spec] (int candidate) { return measure (impulse, key, candidate, spec); });
+
+        load (impulse, key, headLength);
+    }
+
+    void process (const juce::dsp::ProcessContextReplacing<float>& context) noexcept
+    {
+        auto& block = context.getOutputBlock();
+        const auto numSamples = (int) block.getNumSamples();
+
+        // Not prepared yet, the audio goes through untouched
+        jassert (maxBlockSize > 0);
+
+        if (maxBlockSize <= 0)
+            return;
+
+        // Anything over the prepared size goes through in pieces
+        for (int start = 0; start < numSamples; start += maxBlockSize)
+        {
+            auto subBlock = block.getSubBlock ((size_t) start, (size_t) juce::jmin (maxBlockSize, numSamples - start));
+            processBlock (subBlock);
+        }
+    }
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    // How much audio each candidate split gets timed on
+    static constexpr int numMeasuredSamples = 16384;
+    static constexpr int width = (int) Vec::SIMDNumElements;
+
+    // Past input kept for the FIR, enough for the longest direct kernel
+    static constexpr int historyLength = maxDirectLength;
+
+    /** What a kernel runs, built once per impulse, head length and latency. */
+    struct Filter : public juce::ReferenceCountedObject
+    {
+        using Ptr = juce::ReferenceCountedObjectPtr<Filter>;
+
+        int length = 0, numChannels = 0, numVecs = 0, latency = 0;
+
+        // The taps reversed, once per channel for each way a window can sit against the
+        // SIMD alignment, shifted by that many zeros, so every load in the FIR is aligned
+        std::vector<Vec> taps;
+
+        // Everything past the first length taps, or nullptr if the FIR has it all
+        PartitionedConvolution::Filter::Ptr tail;
+
+        /** A headLength of 0 runs the whole impulse in the FIR. With some latency it has no FIR at all. */
+        static Ptr create (const juce::AudioBuffer<float>& impulse, int headLength, int latency)
+        {
+            Ptr filter = new Filter();
+            filter->latency = latency;
+
+            if (latency > 0)
+            {
+                filter->build (impulse, 0);
+                filter->tail = PartitionedConvolution::createFilter (impulse, 0, latency, latency);
+            }
+            else if (headLength > 0)
+            {
+                filter->build (impulse, headLength);
+                filter->tail = PartitionedConvolution::createFilter (impulse, headLength, headLength);
+            }
+            else
+            {
+                filter->build (impulse, impulse.getNumSamples());
+            }
+
+            return filter;
+        }
+
+        void build (const juce::AudioBuffer<float>& impulse, int numTaps)
+        {
+            length = juce::jmax (1, numTaps);
+            numChannels = juce::jmax (1, impulse.getNumChannels());
+            numVecs = (length + width - 1) / width + 1;
+
+            taps.assign ((size_t) (numChannels * width * numVecs), Vec::expand (0.0f));
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                for (int phase = 0; phase < width; ++phase)
+                {
+                    auto* raw = reinterpret_cast<float*> (taps.data() + (channel * width + phase) * numVecs);
+
+                    for (int i = 0; i < numTaps; ++i)
+                        raw[phase + i] = impulse.getSample (channel, numTaps - 1 - i);
+                }
+            }
+        }
+
+        const Vec* getTaps (int channel, int phase) const noexcept
+        {
+            return taps.data() + (channel * width + phase) * numVecs;
+        }
+    };
+
+    struct Kernel
+    {
+        Filter::Ptr filter;
+
+        // This instance's delay lines for the filter's tail
+        PartitionedConvolution tail;
+    };
+
+    /** A headLength of 0 runs the whole impulse in the FIR. key identifies the impulse's contents. */
+    void load (const juce::AudioBuffer<float>& impulse, const juce::String& key, int headLength)
+    {
+        // The head is also the first partition size, so it has to be a power of two
+        const auto numSamples = impulse.getNumSamples();
+        const auto validHead = headLength > 0 && juce::isPowerOfTwo (headLength) && headLength < numSamples && headLength <= maxDirectLength;
+        const auto hasTail = validHead || numSamples > maxDirectLength;
+        headLength = hasTail ? (validHead ? headLength : 256) : 0;
+
+        install (store->get<Filter> (key + "_head_" + juce::String (headLength),
+                                     [&impulse, headLength] { return Filter::create (impulse, headLength, 0); }));
+    }
+
+    /** No FIR head, the whole impulse goes into partitions starting at the latency. */
+    void loadWithLatency (const juce::AudioBuffer<float>& impulse, const juce::String& key, int latency)
+    {
+        install (store->get<Filter> (key + "_latency_" + juce::String (latency),
+                                     [&impulse, latency] { return Filter::create (impulse, 0, latency); }));
+    }
+
+    void install (Filter::Ptr filter)
+    {
+        auto* kernel = getFreeKernel();
+        jassert (kernel != nullptr);
+
+        if (kernel == nullptr)
+            return;
+
+        kernel->filter = std::move (filter);
+
+        if (kernel->filter->tail != nullptr)
+            kernel->tail.prepare (kernel->filter->tail, preparedChannels.load(), preparedSampleRate.load());
+        else
+            kernel->tail.release();
+
+        current.store (kernel);
+    }
+
+    /** Seconds it takes a fresh CabConvolution to run numMeasuredSamples of noise through impulse. */
+    static double measure (const juce::AudioBuffer<float>& impulse, const juce::String& key, int headLength, const juce::dsp::ProcessSpec& spec)
+    {
+        CabConvolution convolution;
+        convolution.prepare (spec);
+        convolution.load (impulse, key, headLength);
+
+        const auto numChannels = (int) spec.numChannels;
+        const auto blockSize = (int) spec.maximumBlockSize;
+
+        juce::AudioBuffer<float> noise (numChannels, blockSize), buffer (numChannels, blockSize);
+        juce::Random random (1);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            for (int i = 0; i < blockSize; ++i)
+                noise.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+        // The first pass warms up the caches and the workers, the second one is timed
+        double seconds = 0.0;
+
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (int done = 0; done < numMeasuredSamples; done += blockSize)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    buffer.copyFrom (channel, 0, noise, channel, 0, blockSize);
+
+                juce::dsp::AudioBlock<float> block (buffer);
+                convolution.process (juce::dsp::ProcessContextReplacing<float> (block));
+            }
+
+            seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+        }
+
+        return seconds;
+    }
+
+    Kernel* getFreeKernel() noexcept
+    {
+        for (auto& kernel : kernels)
+            if (&kernel != current.load() && &kernel != activeKernel.load() && &kernel != previousKernel.load())
+                return &kernel;
+
+        return nullptr;
+    }
+
+    /** Audio thread. Takes the newest kernel unless a crossfade is still running. */
+    void updateKernel() noexcept
+    {
+        if (mix.isSmoothing())
+            return;
+
+        auto* latest = current.load();
+
+        if (latest == active)
+            return;
+
+        // The kernel being faded out has to stay marked the whole time, so it moves to
+        // previous before active moves on
+        previousKernel.store (active);
+
+        // Mark before taking it so the loader can't start writing over it
+        for (;;)
+        {
+            activeKernel.store (latest);
+
+            auto* again = current.load();
+
+            if (again == latest)
+                break;
+
+            latest = again;
+        }
+
+        previous = active;
+        active = latest;
+
+        if (previous == nullptr)
+            return;
+
+        ducking = previous->filter->latency != active->filter->latency;
+        mix.setCurrentAndTargetValue (0.0f);
+        mix.setTargetValue (1.0f);
+    }
+
+    void finishCrossfade() noexcept
+    {
+        mix.setCurrentAndTargetValue (1.0f);
+        previous = nullptr;
+        previousKernel.store (nullptr);
+    }
+
+    void processBlock (juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        updateKernel();
+
+        const auto numSamples = (int) block.getNumSamples();
+        const auto numChannels = juce::jmin (block.getNumChannels(), history.size());
+
+        // The FIR history carries on across impulse changes so a new kernel's head starts warm
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            auto* past = reinterpret_cast<float*> (history[channel].data());
+            std::copy (block.getChannelPointer (channel), block.getChannelPointer (channel) + numSamples, past + historyLength);
+            inputPointers[channel] = past + historyLength;
+        }
+
+        if (active == nullptr)
+        {
+            shiftHistory (numSamples, numChannels);
+            return;
+        }
+
+        if (previous != nullptr)
+        {
+            auto fadeBlock = juce::dsp::AudioBlock<float> (fadeBuffer).getSubsetChannelBlock (0, numChannels)
+                                                                      .getSubBlock (0, (size_t) numSamples);
+
+            processKernel (*previous, fadeBlock, numChannels);
+            processKernel (*active, block, numChannels);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto amount = mix.getNextValue();
+
+                // A dip fades the old kernel out over the first half and the new one in over the second
+                const auto outgoing = ducking ? juce::jmax (0.0f, 1.0f - 2.0f * amount) : 1.0f - amount;
+                const auto incoming = ducking ? juce::jmax (0.0f, 2.0f * amount - 1.0f) : amount;
+
+                for (size_t channel = 0; channel < numChannels; ++channel)
+                {
+                    auto& sample = block.getChannelPointer (channel)[i];
+                    sample = outgoing * fadeBlock.getSample ((int) channel, i) + incoming * sample;
+                }
+            }
+
+            if (! mix.isSmoothing())
+            {
+                previous = nullptr;
+                previousKernel.store (nullptr);
+            }
+        }
+        else
+        {
+            processKernel (*active, block, numChannels);
+        }
+
+        shiftHistory (numSamples, numChannels);
+    }
+
+    void processKernel (Kernel& kernel, juce::dsp::AudioBlock<float>& block, size_t numChannels) noexcept
+    {
+        auto channels = block.getSubsetChannelBlock (0, numChannels);
+        const auto& filter = *kernel.filter;
+
+        if (filter.latency > 0)
+            channels.clear();
+        else
+            processDirect (filter, channels, numChannels);
+
+        if (filter.tail != nullptr)
+            kernel.tail.processAdding (inputPointers.data(), channels);
+    }
+
+    /** Writes the FIR output for the samples already copied into the history. */
+    void processDirect (const Filter& filter, juce::dsp::AudioBlock<float>& block, size_t numChannels) const noexcept
+    {
+        const auto numSamples = (int) block.getNumSamples();
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            // A mono impulse runs on every channel
+            const auto kernelChannel = juce::jmin ((int) channel, filter.numChannels - 1);
+            const auto* past = reinterpret_cast<const float*> (history[channel].data());
+            auto* out = block.getChannelPointer (channel);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                // Output i is the dot product of the taps with the window ending on input i
+                const auto windowStart = historyLength - filter.length + 1 + i;
+                const auto phase = windowStart % width;
+                const auto* window = past + (windowStart - phase);
+                const auto* taps = filter.getTaps (kernelChannel, phase);
+
+                auto sum = Vec::expand (0.0f);
+
+                for (int v = 0; v < filter.numVecs; ++v)
+                    sum = Vec::multiplyAdd (sum, taps[v], Vec::fromRawArray (window + v * width));
+
+                out[i] = sum.sum();
+            }
+        }
+    }
+
+    void shiftHistory (int numSamples, size_t numChannels) noexcept
+    {
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            auto* past = reinterpret_cast<float*> (history[channel].data());
+            std::copy (past + numSamples, past + numSamples + historyLength, past);
+        }
+    }
+
+    // Per channel, historyLength samples of past input followed by the current block
+    std::vector<std::vector<Vec>> history;
+    std::vector<const float*> inputPointers;
+    juce::AudioBuffer<float> fadeBuffer;
+    int maxBlockSize = 0;
+    std::atomic<int> preparedBlockSize { 512 }, preparedChannels { 2 }, requestedLatency { 0 };
+    std::atomic<double> preparedSampleRate { 44100.0 };
+
+    // Audio thread only
+    Kernel* active = nullptr;
+    Kernel* previous = nullptr;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> mix;
+    bool ducking = false;
+
+    // The loader writes into whichever slot isn't published, playing or fading out
+    std::array<Kernel, 4> kernels;
+    std::atomic<Kernel*> current { nullptr };
+    std::atomic<const Kernel*> activeKernel { nullptr }, previousKernel { nullptr };
+    juce::CriticalSection loadLock;
+
+    juce::SharedResourcePointer<ConvolutionTuner> tuner;
+    juce::SharedResourcePointer<ImpulseStore> store;
+
+   #if JUCE_UNIT_TESTS
+    // Loads impulses with a given head length rather than the one the tuner picks
+    friend class ConvolutionTests;
+   #endif
+};
@@ -0,0 +1,266 @@
+/*
+  ==============================================================================
+
+    CabImpulse.h
+    Created: 17 Oct 2026 4:02:36pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ImpulseStore.h"
+#include "ImpulseCache.h"
+
+//==============================================================================
+/** The cab impulse response, decoded once and kept at its own sample rate.
+
+    The plain cab and the folded EQ + cab convolutions both load what
+    getResampled() returns as is, so the two are conditioned the same way
+    and never jump in level when swapped.
+
+    The decoded and resampled impulses live in the ImpulseStore under a hash of
+    the file's bytes, so every instance on the same cab shares one copy of each,
+    whatever path it came from. Impulses from files are also written to the
+    ImpulseCache once resampled, under the file's path and modification time. A
+    file found there isn't read, hashed or decoded at all, the cache hands back
+    the hash of its contents and the impulse is mapped back in at the new rate.
+
+    The FFT partitions built from the impulse aren't cached on disk. How an
+    impulse is cut up depends on the host's block size, the cab latency and which
+    split the ConvolutionTuner timed fastest on this machine, and building them
+    takes one forward FFT per partition, in memory, with no file to read.
+*/
+class CabImpulse
+{
+public:
+    CabImpulse()
+    {
+        formats.registerBasicFormats();
+    }
+
+    /** Returns false and keeps the previous impulse if the file can't be read. */
+    bool loadFromFile (const juce::File& file)
+    {
+        const auto cacheKey = ImpulseCache::getKey (file);
+
+        // Cached before means it decodes fine, and it only needs decoding if a rate it wasn't cached at comes up
+        auto key = diskCache->getContentKey (cacheKey);
+
+        if (key.isNotEmpty())
+        {
+            source = nullptr;
+        }
+        else
+        {
+            juce::MemoryBlock data;
+
+            if (! file.loadFileAsData (data))
+                return false;
+
+            key = ImpulseStore::hash (data.getData(), data.getSize());
+            auto decoded = store->get<ImpulseData> ("decoded_" + key, [this, &data] { return decode (data.getData(), data.getSize()); });
+
+            if (decoded == nullptr)
+                return false;
+
+            source = std::move (decoded);
+        }
+
+        sourceFile = file;
+        sourceKey = key;
+        sourceCacheKey = cacheKey;
+        return true;
+    }
+
+    bool loadFromMemory (const void* data, size_t size)
+    {
+        const auto key = ImpulseStore::hash (data, size);
+
+        auto decoded = store->get<ImpulseData> ("decoded_" + key, [this, data, size] { return decode (data, size); });
+
+        if (decoded == nullptr)
+            return false;
+
+        source = std::move (decoded);
+        sourceFile = juce::File();
+        sourceKey = key;
+        sourceCacheKey = {};
+        return true;
+    }
+
+    /** What was last loaded, by its contents, empty before anything has been. */
+    const juce::String& getKey() const noexcept
+    {
+        return sourceKey;
+    }
+
+    /** True if file, as it is on disk now, is what was last loaded. */
+    bool isLoaded (const juce::File& file) const
+    {
+        return sourceFile == file && sourceCacheKey == ImpulseCache::getKey (file);
+    }
+
+    /** True if these bytes are what was last loaded. */
+    bool isLoaded (const void* data, size_t size) const
+    {
+        return sourceFile == juce::File() && sourceKey == ImpulseStore::hash (data, size);
+    }
+
+    /** The trimmed impulse at sampleRate, normalised like juce::dsp::Convolution's Normalise::yes. */
+    ImpulseData::Ptr getResampled (double sampleRate) const
+    {
+        if (sourceKey.isEmpty())
+            return getSilence (sampleRate);
+
+        auto resampled = store->get<ImpulseData> ("resampled_" + sourceKey + "_" + juce::String (sampleRate), [this, sampleRate]
+        {
+            const auto fromFile = sourceFile != juce::File();
+
+            if (fromFile)
+            {
+                auto cached = diskCache->read (sourceCacheKey, sampleRate);
+
+                if (cached != nullptr)
+                    return cached;
+            }
+
+            auto decoded = source != nullptr ? source : decode (sourceFile);
+
+            if (decoded == nullptr)
+                return ImpulseData::Ptr();
+
+            auto result = resample (*decoded, sampleRate);
+
+            if (fromFile)
+                diskCache->write (sourceCacheKey, sourceKey, *result);
+
+            return result;
+        });
+
+        // Only if the file went missing since it was cached at another rate
+        return resampled != nullptr ? resampled : getSilence (sampleRate);
+    }
+
+private:
+    static ImpulseData::Ptr getSilence (double sampleRate)
+    {
+        ImpulseData::Ptr silence = new ImpulseData();
+        silence->buffer.setSize (1, 1);
+        silence->buffer.clear();
+        silence->sampleRate = sampleRate;
+        return silence;
+    }
+
+    static ImpulseData::Ptr resample (const ImpulseData& decoded, double sampleRate)
+    {
+        ImpulseData::Ptr result = new ImpulseData();
+        result->sampleRate = sampleRate;
+
+        auto& resampled = result->buffer;
+        const auto ratio = decoded.sampleRate / sampleRate;
+
+        if (ratio == 1.0)
+        {
+            resampled.makeCopyOf (decoded.buffer);
+        }
+        else
+        {
+            // Same as juce::dsp::Convolution, ResamplingAudioSource low-passes before it decimates
+            // so a 96 or 192 kHz impulse doesn't alias into a 44.1 or 48 kHz session
+            juce::AudioBuffer<float> original;
+            original.makeCopyOf (decoded.buffer);
+
+            juce::MemoryAudioSource memorySource (original, false);
+            juce::ResamplingAudioSource resamplingSource (&memorySource, false, original.getNumChannels());
+
+            const auto numSamples = juce::roundToInt (juce::jmax (1.0, original.getNumSamples() / ratio));
+            resamplingSource.setResamplingRatio (ratio);
+            resamplingSource.prepareToPlay (numSamples, decoded.sampleRate);
+
+            resampled.setSize (original.getNumChannels(), numSamples);
+            resamplingSource.getNextAudioBlock ({ &resampled, 0, numSamples });
+        }
+
+        const auto numSamples = resampled.getNumSamples();
+        auto loudest = 0.0f;
+
+        for (int channel = 0; channel < resampled.getNumChannels(); ++channel)
+        {
+            const auto* data = resampled.getReadPointer (channel);
+            loudest = juce::jmax (loudest, std::inner_product (data, data + numSamples, data, 0.0f));
+        }
+
+        // juce::dsp::Convolution's Normalise::yes level, so presets sound as loud as they always did
+        if (loudest > 0.0f)
+            resampled.applyGain (0.125f / std::sqrt (loudest));
+
+        return result;
+    }
+
+    ImpulseData::Ptr decode (const void* data, size_t size) const
+    {
+        return decode (std::unique_ptr<juce::AudioFormatReader> (formats.createReaderFor (std::make_unique<juce::MemoryInputStream> (data, size, false))));
+    }
+
+    ImpulseData::Ptr decode (const juce::File& file) const
+    {
+        return decode (std::unique_ptr<juce::AudioFormatReader> (formats.createReaderFor (file)));
+    }
+
+    static ImpulseData::Ptr decode (std::unique_ptr<juce::AudioFormatReader> reader)
+    {
+        if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+            return nullptr;
+
+        // Only the first two channels are ever used, stereo like the convolution
+        const auto numChannels = juce::jmin (2, (int) reader->numChannels);
+        juce::AudioBuffer<float> decoded (numChannels, (int) reader->lengthInSamples);
+        reader->read (&decoded, 0, decoded.getNumSamples(), 0, true, numChannels > 1);
+
+        // Trim silence off both ends, -80 dB like juce::dsp::Convolution::Trim::yes
+        const auto threshold = juce::Decibels::decibelsToGain (-80.0f);
+        auto start = decoded.getNumSamples(), end = 0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* data = decoded.getReadPointer (channel);
+
+            for (int i = 0; i < decoded.getNumSamples(); ++i)
+            {
+                if (std::abs (data[i]) >= threshold)
+                {
+                    start = juce::jmin (start, i);
+                    end = juce::jmax (end, i + 1);
+                }
+            }
+        }
+
+        if (start >= end)
+            return nullptr;
+
+        ImpulseData::Ptr trimmed = new ImpulseData();
+        trimmed->buffer.setSize (numChannels, end - start);
+        trimmed->sampleRate = reader->sampleRate;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            trimmed->buffer.copyFrom (channel, 0, decoded, channel, start, end - start);
+
+        return trimmed;
+    }
+
+    // getResampled() has to decode a cached file again if a new rate comes up
+    mutable juce::AudioFormatManager formats;
+    // source is only left empty for a file that is already in the disk cache
+    ImpulseData::Ptr source;
+    juce::File sourceFile;
+    // sourceKey hashes the bytes for the store, sourceCacheKey is the file's path and time for the disk cache
+    juce::String sourceKey, sourceCacheKey;
+
+    juce::SharedResourcePointer<ImpulseStore> store;
+    juce::SharedResourcePointer<ImpulseCache> diskCache;
+
+    JUCE_DECLARE_NON_COPYABLE (CabImpulse)
+};
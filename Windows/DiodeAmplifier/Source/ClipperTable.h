@@ -0,0 +1,304 @@
+/*
+  ==============================================================================
+
+    ClipperTable.h
+    Created: 17 Oct 2026 11:40:05am
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DiodeClipper.h"
+
+//==============================================================================
+/** The diode curve for one drive setting, sampled into a table.
+
+    At high drive the curve goes from rail to rail in a tiny window around zero,
+    so the table is indexed by the float bits of |x|: every octave gets the same
+    number of points, which keeps the linear interpolation error the same at any drive.
+
+    The first and second antiderivatives of the curve are integrated onto the
+    same points for the ADAA clipper modes.
+*/
+struct ClipperTable
+{
+    static constexpr int stepsPerOctave = 64;
+    static constexpr int minExponent = -30;
+    static constexpr int maxExponent = 4;
+    static constexpr int size = (maxExponent - minExponent) * stepsPerOctave + 1;
+
+    static constexpr int fractionBits = 23 - 6;
+    static_assert (1 << (23 - fractionBits) == stepsPerOctave, "fractionBits must match stepsPerOctave");
+    static constexpr uint32_t indexOffset = (uint32_t) (minExponent + 127) * stepsPerOctave;
+
+    void build (float newDriveScaled)
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            const auto x = std::ldexp (1.0f + (float) (i % stepsPerOctave) / (float) stepsPerOctave, minExponent + i / stepsPerOctave);
+
+            positive[i] = DiodeClipper::processSampleReference (x, newDriveScaled);
+            negative[i] = DiodeClipper::processSampleReference (-x, newDriveScaled);
+        }
+
+        // Below 2^minExponent the curve is a straight line through zero
+        const auto smallest = std::ldexp (1.0f, minExponent);
+        positiveSlope = positive[0] / smallest;
+        negativeSlope = negative[0] / smallest;
+
+        integrate (positiveIntegrals, newDriveScaled, 1.0);
+        integrate (negativeIntegrals, newDriveScaled, -1.0);
+
+        driveScaled = newDriveScaled;
+    }
+
+    float processSample (float input) const noexcept
+    {
+        uint32_t bits;
+        std::memcpy (&bits, &input, sizeof (bits));
+
+        const auto isNegative = (bits >> 31) != 0;
+        bits &= 0x7fffffffu;
+
+        const auto* table = isNegative ? negative.data() : positive.data();
+        const auto index = (int) (bits >> fractionBits) - (int) indexOffset;
+
+        if (index < 0)
+            return std::abs (input) * (isNegative ? negativeSlope : positiveSlope);
+
+        if (index >= size - 1)
+            return table[size - 1];
+
+        const auto fraction = (float) (bits & ((1u << fractionBits) - 1)) * (1.0f / (float) (1u << fractionBits));
+
+        return table[index] + fraction * (table[index + 1] - table[index]);
+    }
+
+    template <typename SampleType>
+    void process (SampleType* data, int numSamples) const noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = (SampleType) processSample ((float) data[i]);
+    }
+
+    /** First and second antiderivatives of the curve at x, both zero at x = 0.
+        Cubic Hermite between the table points, using the curve as the slope of the first
+        and the first as the slope of the second.
+    */
+    void getAntiderivatives (double x, double& first, double& second) const noexcept
+    {
+        const auto sign = x < 0.0 ? -1.0 : 1.0;
+        const auto u = std::abs (x);
+        const auto& integrals = sign < 0.0 ? negativeIntegrals : positiveIntegrals;
+        const auto* curve = sign < 0.0 ? negative.data() : positive.data();
+
+        const auto uFloat = (float) u;
+        uint32_t bits;
+        std::memcpy (&bits, &uFloat, sizeof (bits));
+
+        const auto index = (int) (bits >> fractionBits) - (int) indexOffset;
+
+        // Straight line through zero, or flat past the last point
+        if (index < 0)
+        {
+            const auto slope = (double) (sign < 0.0 ? negativeSlope : positiveSlope);
+            first = sign * slope * u * u * 0.5;
+            second = slope * u * u * u / 6.0;
+            return;
+        }
+
+        if (index >= size - 1)
+        {
+            const auto d = u - (double) maxInput;
+            const auto end = sign * (double) curve[size - 1];
+            first = integrals[size - 1].first + end * d;
+            second = integrals[size - 1].second + sign * (integrals[size - 1].first * d + end * d * d * 0.5);
+            return;
+        }
+
+        // Table point below u and the spacing to the next one, straight from the float bits
+        const auto pointBits = bits & ~((1u << fractionBits) - 1);
+        const auto spacingBits = ((bits >> 23) - (uint32_t) (23 - fractionBits)) << 23;
+        float point, spacing;
+        std::memcpy (&point, &pointBits, sizeof (point));
+        std::memcpy (&spacing, &spacingBits, sizeof (spacing));
+
+        const auto h = (double) spacing;
+        const auto t = (u - (double) point) / h;
+        const auto t2 = t * t;
+        const auto t3 = t2 * t;
+
+        const auto h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+        const auto h10 = t3 - 2.0 * t2 + t;
+        const auto h01 = 3.0 * t2 - 2.0 * t3;
+        const auto h11 = t3 - t2;
+
+        const auto& a = integrals[index];
+        const auto& b = integrals[index + 1];
+
+        first = h00 * a.first + h01 * b.first + h * sign * (h10 * (double) curve[index] + h11 * (double) curve[index + 1]);
+        second = h00 * a.second + h01 * b.second + h * sign * (h10 * a.first + h11 * b.first);
+    }
+
+    float driveScaled = -1.0f;
+
+private:
+    struct Integrals
+    {
+        double first, second;
+    };
+
+    static constexpr float maxInput = (float) (1 << maxExponent);
+
+    static double getPoint (int index)
+    {
+        return std::ldexp (1.0 + (double) (index % stepsPerOctave) / (double) stepsPerOctave, minExponent + index / stepsPerOctave);
+    }
+
+    // The curve in double precision, only used while integrating
+    static double curveAt (double input, double newDriveScaled)
+    {
+        return DiodeClipper::processSampleExact (input, newDriveScaled);
+    }
+
+    /** Integrates outwards from zero along one side with 5 point Gauss-Legendre per table step.
+        With u = |x| the first antiderivative has slope sign * f (sign * u), the second sign * first.
+    */
+    static void integrate (std::array<Integrals, size>& integrals, double newDriveScaled, double sign)
+    {
+        static constexpr double nodes[] = { 0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640 };
+        static constexpr double weights[] = { 0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891 };
+
+        double first = 0.0, second = 0.0, start = 0.0;
+
+        for (int i = 0; i < size; ++i)
+        {
+            const auto end = getPoint (i);
+            const auto halfWidth = (end - start) * 0.5;
+            double area = 0.0, moment = 0.0;
+
+            for (int n = 0; n < 5; ++n)
+            {
+                const auto r = start + halfWidth * (1.0 + nodes[n]);
+                const auto slope = sign * curveAt (sign * r, newDriveScaled);
+
+                area += weights[n] * slope;
+                moment += weights[n] * (end - r) * slope;
+            }
+
+            second += sign * ((end - start) * first + moment * halfWidth);
+            first += area * halfWidth;
+
+            integrals[i] = { first, second };
+            start = end;
+        }
+    }
+
+    float positiveSlope = 0.0f, negativeSlope = 0.0f;
+    std::array<float, size> positive {}, negative {};
+    std::array<Integrals, size> positiveIntegrals {}, negativeIntegrals {};
+};
+
+//==============================================================================
+/** Keeps the clipper table in step with the drive knob.
+
+    Tables are rebuilt on a background thread shared by every instance and
+    published through an atomic pointer. The audio thread marks the table it is
+    reading, so with three tables the builder always has a free one to write into.
+*/
+class ClipperTableBuilder : private juce::TimeSliceClient
+{
+public:
+    ClipperTableBuilder()
+    {
+        buildThread->addTimeSliceClient (this);
+    }
+
+    ~ClipperTableBuilder() override
+    {
+        buildThread->removeTimeSliceClient (this);
+    }
+
+    /** Builds the table for driveScaled right away, call from prepareToPlay. */
+    void prepare (float driveScaled)
+    {
+        setDrive (driveScaled);
+        rebuild();
+    }
+
+    /** Asks for a new table, safe to call from any thread. */
+    void setDrive (float driveScaled) noexcept
+    {
+        requestedDrive.store (driveScaled);
+    }
+
+    /** Audio thread only. Returns nullptr while the table for driveScaled is still being built. */
+    const ClipperTable* acquire (float driveScaled) noexcept
+    {
+        auto* table = current.load();
+
+        for (;;)
+        {
+            inUse.store (table);
+
+            auto* latest = current.load();
+
+            if (latest == table)
+                break;
+
+            table = latest;
+        }
+
+        return table->driveScaled == driveScaled ? table : nullptr;
+    }
+
+    void release() noexcept
+    {
+        inUse.store (nullptr);
+    }
+
+private:
+    struct BuildThread : public juce::TimeSliceThread
+    {
+        BuildThread() : juce::TimeSliceThread ("Diode clipper tables") { startThread(); }
+        ~BuildThread() override { stopThread (1000); }
+    };
+
+    int useTimeSlice() override
+    {
+        rebuild();
+        return 10;
+    }
+
+    void rebuild()
+    {
+        const juce::ScopedLock sl (buildLock);
+        const auto drive = requestedDrive.load();
+
+        if (current.load()->driveScaled == drive)
+            return;
+
+        for (auto& table : tables)
+        {
+            if (&table != current.load() && &table != inUse.load())
+            {
+                table.build (drive);
+                current.store (&table);
+                return;
+            }
+        }
+    }
+
+    std::array<ClipperTable, 3> tables;
+    std::atomic<ClipperTable*> current { &tables[0] };
+    std::atomic<const ClipperTable*> inUse { nullptr };
+    std::atomic<float> requestedDrive { 1.0f };
+
+    juce::CriticalSection buildLock;
+    juce::SharedResourcePointer<BuildThread> buildThread;
+
+    JUCE_DECLARE_NON_COPYABLE (ClipperTableBuilder)
+};
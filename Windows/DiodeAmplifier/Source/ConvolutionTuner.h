@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    ConvolutionTuner.h
+    Created: 17 Oct 2026 9:05:33pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Picks how CabConvolution splits an impulse by timing the options on this machine.
+
+    The answer is a head length: 0 runs the whole impulse in the FIR, anything
+    else is the FIR head and first partition size in front of the FFT tail. It
+    depends on the CPU, the block size and the impulse length, so the winner is
+    kept per machine, block size and power of two impulse length in a settings
+    file and only measured the first time that combination comes up.
+*/
+class ConvolutionTuner
+{
+public:
+    ConvolutionTuner() : results (getOptions()) {}
+
+    /** Loading thread. measure (headLength) runs the impulse split that way and returns how long it took. */
+    template <typename Measure>
+    int getHeadLength (int impulseLength, int numChannels, int blockSize, int maxDirectLength, Measure&& measure)
+    {
+        const auto key = juce::SystemStats::getCpuModel() + "_" + juce::String (juce::SystemStats::getNumCpus())
+                       + "_" + juce::String (blockSize) + "_" + juce::String (juce::nextPowerOfTwo (impulseLength))
+                       + "_" + juce::String (numChannels);
+
+        {
+            const juce::ScopedLock sl (lock);
+
+            if (results.containsKey (key))
+                return results.getIntValue (key);
+        }
+
+        auto best = 0;
+        auto bestTime = std::numeric_limits<double>::max();
+
+        // The whole bucket fits in the FIR or none of it does, maxDirectLength is a power of two
+        if (juce::nextPowerOfTwo (impulseLength) <= maxDirectLength)
+            bestTime = measure (0);
+
+        for (auto headLength = 32; headLength <= 512 && headLength < impulseLength; headLength *= 2)
+        {
+            const auto time = measure (headLength);
+
+            if (time < bestTime)
+            {
+                best = headLength;
+                bestTime = time;
+            }
+        }
+
+        const juce::ScopedLock sl (lock);
+        results.setValue (key, best);
+        results.saveIfNeeded();
+        return best;
+    }
+
+private:
+    static juce::PropertiesFile::Options getOptions()
+    {
+        juce::PropertiesFile::Options options;
+        options.applicationName = "DiodeAmplifier";
+        options.filenameSuffix = ".tuning";
+        options.folderName = "DiodeAmplifier";
+        options.osxLibrarySubFolder = "Application Support";
+        options.millisecondsBeforeSaving = -1;
+        return options;
+    }
+
+    juce::CriticalSection lock;
+    juce::PropertiesFile results;
+
+    JUCE_DECLARE_NON_COPYABLE (ConvolutionTuner)
+};
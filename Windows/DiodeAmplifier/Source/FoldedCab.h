@@ -0,0 +1,411 @@
+/*
+  ==============================================================================
+
+    FoldedCab.h
+    Created: 17 Oct 2026 4:31:52pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "BiquadCascade.h"
+#include "CabConvolution.h"
+#include "ImpulseStore.h"
+
+//==============================================================================
+/** Runs the post clip tone filters and the cab as one convolution when the tone is static.
+
+    The tone filters and the cab are both linear, so once the tone controls settle a
+    background thread filters the cab impulse through them and loads the result into
+    a second convolution. That one is warmed up on the live signal, then crossfaded in
+    and the tone filters and plain cab stop running. Any tone or cab change warms
+    them back up the same way, with the composite still playing, then fades back
+    to them until a new composite is ready.
+*/
+class FoldedCab : private juce::TimeSliceClient
+{
+public:
+    static constexpr size_t numToneStages = 4;
+
+    FoldedCab()
+    {
+        for (auto& coefficients : toneCoefficients)
+            coefficients = { 1.0, 0.0, 0.0, 0.0, 0.0 };
+
+        buildThread->addTimeSliceClient (this);
+    }
+
+    ~FoldedCab() override
+    {
+        buildThread->removeTimeSliceClient (this);
+    }
+
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        foldedConvolution.prepare (spec);
+        foldedBuffer.setSize ((int) spec.numChannels, (int) spec.maximumBlockSize);
+        cabBuffer.setSize ((int) spec.numChannels, (int) spec.maximumBlockSize);
+
+        mix.reset (spec.sampleRate, 0.05);
+        mix.setCurrentAndTargetValue (0.0f);
+        warmUpRemaining = -1;
+        unfoldRemaining = -1;
+        runFolded = false;
+        runUnfolded = true;
+        blockRemaining = 0;
+        nextBlockLength = 0;
+    }
+
+    /** Audio thread. The next numSamples make up one block, however many process() calls they
+        come in. Whether to fold, and what runs, is settled once for all of them.
+    */
+    void beginBlock (size_t numSamples) noexcept
+    {
+        nextBlockLength = numSamples;
+        blockRemaining = 0;
+    }
+
+    /** Audio thread. Clears the composite's history, the filters and cab are reset by their owner. */
+    void reset() noexcept
+    {
+        foldedConvolution.reset();
+    }
+
+    /** Loading thread. Keeps a reference to the shared impulse, which has to be at the prepared rate. */
+    void setCabImpulse (ImpulseData::Ptr impulse)
+    {
+        // The plain cab needs the impulse's length of input, the tone filters a little longer, before it sounds
+        // like it never stopped. Capped at a second, past that the stale composite would play on for too long,
+        // and what's left of a tail that far in is faint
+        if (impulse != nullptr && impulse->sampleRate > 0.0)
+            unfoldLength.store (juce::jmin (impulse->buffer.getNumSamples() + (int) (impulse->sampleRate * toneRingSeconds),
+                                            (int) (impulse->sampleRate * maxUnfoldSeconds)));
+
+        {
+            const juce::ScopedLock sl (cabLock);
+            cabImpulse = std::move (impulse);
+        }
+
+        changed();
+    }
+
+    /** Loading thread. Has the composite built with the same delay as the plain cab. */
+    void setLatency (int latency)
+    {
+        foldedConvolution.setLatency (latency);
+        changed();
+    }
+
+    /** Any thread. Composites are only built while this is on, i.e. Fold EQ and the cab are both on. */
+    void setFoldingEnabled (bool shouldFold) noexcept
+    {
+        foldingPossible.store (shouldFold);
+    }
+
+    /** Any thread, mirrors what the tone filters were just given. */
+    void setToneCoefficients (size_t stage, const BiquadCoefficients& coefficients) noexcept
+    {
+        {
+            const juce::SpinLock::ScopedLockType sl (toneLock);
+            toneCoefficients[stage] = coefficients;
+        }
+
+        changed();
+    }
+
+    /** Audio thread. Processes the block through the tone filters and cab, or the composite. */
+    template <typename SampleType>
+    void process (juce::dsp::AudioBlock<SampleType>& block, bool foldingEnabled,
+                  BiquadCascade<SampleType, numToneStages>& toneFilters, CabConvolution& cabConvolution) noexcept
+    {
+        const auto numSamples = (int) block.getNumSamples();
+
+        // Without a beginBlock() this call is a block of its own
+        if (blockRemaining == 0)
+            startBlock (nextBlockLength > 0 ? nextBlockLength : (size_t) numSamples, foldingEnabled, toneFilters, cabConvolution);
+
+        blockRemaining -= juce::jmin ((size_t) numSamples, blockRemaining);
+
+        if (runFolded && runUnfolded)
+        {
+            auto foldedBlock = getFloatBlock (foldedBuffer, block);
+            copySamples (block, foldedBlock);
+            foldedConvolution.process (juce::dsp::ProcessContextReplacing<float> (foldedBlock));
+
+            toneFilters.process (juce::dsp::ProcessContextReplacing<SampleType> (block));
+            convolve (cabConvolution, block);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto amount = (SampleType) mix.getNextValue();
+
+                for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+                {
+                    auto& sample = block.getChannelPointer (channel)[i];
+                    sample += amount * ((SampleType) foldedBlock.getSample ((int) channel, i) - sample);
+                }
+            }
+        }
+        else if (runFolded)
+        {
+            convolve (foldedConvolution, block);
+            mix.skip (numSamples);
+        }
+        else
+        {
+            toneFilters.process (juce::dsp::ProcessContextReplacing<SampleType> (block));
+            convolve (cabConvolution, block);
+            mix.skip (numSamples);
+        }
+
+        if (warmUpRemaining >= 0)
+        {
+            warmUpRemaining = juce::jmax (0, warmUpRemaining - numSamples);
+
+            // The fade in waits for the block to end, like any other decision
+            if (warmUpRemaining == 0 && blockRemaining == 0)
+            {
+                warmUpRemaining = -1;
+                mix.setTargetValue (1.0f);
+            }
+        }
+
+        if (unfoldRemaining >= 0)
+        {
+            unfoldRemaining = juce::jmax (0, unfoldRemaining - numSamples);
+
+            if (unfoldRemaining == 0 && blockRemaining == 0)
+            {
+                unfoldRemaining = -1;
+                mix.setTargetValue (0.0f);
+            }
+        }
+    }
+
+private:
+    struct BuildThread : public juce::TimeSliceThread
+    {
+        BuildThread() : juce::TimeSliceThread ("Folded cab impulses") { startThread(); }
+        ~BuildThread() override { stopThread (1000); }
+    };
+
+    using ToneCoefficients = std::array<BiquadCoefficients, numToneStages>;
+
+    // How long the tone has to stay put before a composite is built
+    static constexpr juce::uint32 settleTimeMs = 300;
+
+    // How long the tone filters ring, and the most the filters and plain cab get to warm up before they take over
+    static constexpr double toneRingSeconds = 0.05, maxUnfoldSeconds = 1.0;
+
+    template <typename SampleType>
+    static juce::dsp::AudioBlock<float> getFloatBlock (juce::AudioBuffer<float>& buffer, const juce::dsp::AudioBlock<SampleType>& block) noexcept
+    {
+        return juce::dsp::AudioBlock<float> (buffer).getSubsetChannelBlock (0, block.getNumChannels())
+                                                    .getSubBlock (0, block.getNumSamples());
+    }
+
+    template <typename SourceType, typename DestinationType>
+    static void copySamples (const juce::dsp::AudioBlock<SourceType>& source, juce::dsp::AudioBlock<DestinationType>& destination) noexcept
+    {
+        for (size_t channel = 0; channel < source.getNumChannels(); ++channel)
+        {
+            const auto* in = source.getChannelPointer (channel);
+            auto* out = destination.getChannelPointer (channel);
+
+            for (size_t i = 0; i < source.getNumSamples(); ++i)
+                out[i] = (DestinationType) in[i];
+        }
+    }
+
+    static void convolve (CabConvolution& convolution, juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        convolution.process (juce::dsp::ProcessContextReplacing<float> (block));
+    }
+
+    // The convolution only runs in float, the double path converts around it
+    void convolve (CabConvolution& convolution, juce::dsp::AudioBlock<double>& block) noexcept
+    {
+        auto floatBlock = getFloatBlock (cabBuffer, block);
+        copySamples (block, floatBlock);
+        convolution.process (juce::dsp::ProcessContextReplacing<float> (floatBlock));
+        copySamples (floatBlock, block);
+    }
+
+    void changed() noexcept
+    {
+        lastChangeTime.store (juce::Time::getMillisecondCounter());
+        ++requestedVersion;
+    }
+
+    template <typename SampleType>
+    void startBlock (size_t numSamples, bool foldingEnabled,
+                     BiquadCascade<SampleType, numToneStages>& toneFilters, CabConvolution& cabConvolution) noexcept
+    {
+        nextBlockLength = 0;
+        blockRemaining = numSamples;
+
+        const auto canFold = foldingEnabled && readyVersion.load() == requestedVersion.load();
+
+        if (! canFold)
+        {
+            warmUpRemaining = -1;
+
+            // Still fading in, the filters and cab are warm so go straight back
+            if (mix.isSmoothing())
+                mix.setTargetValue (0.0f);
+            else if (mix.getCurrentValue() > 0.0f && unfoldRemaining < 0)
+                startUnfolding (toneFilters, cabConvolution);
+        }
+        else if (mix.getTargetValue() == 0.0f)
+        {
+            // Still fading out, the composite is warm so go straight back
+            if (mix.isSmoothing())
+                mix.setTargetValue (1.0f);
+            else if (warmUpRemaining < 0)
+                startWarmUp();
+        }
+        else
+        {
+            // A new composite came in before the filters took over, it carries on
+            unfoldRemaining = -1;
+        }
+
+        runFolded = warmUpRemaining >= 0 || mix.isSmoothing() || mix.getCurrentValue() > 0.0f;
+        runUnfolded = unfoldRemaining >= 0 || mix.isSmoothing() || mix.getCurrentValue() < 1.0f;
+    }
+
+    void startWarmUp() noexcept
+    {
+        foldedConvolution.reset();
+        warmUpRemaining = warmUpLength.load();
+    }
+
+    /** Brings the filters and plain cab back from idle on the live signal, the composite plays until they're warm. */
+    template <typename SampleType>
+    void startUnfolding (BiquadCascade<SampleType, numToneStages>& toneFilters, CabConvolution& cabConvolution) noexcept
+    {
+        // Whatever they held from before folding is long gone
+        toneFilters.reset();
+        cabConvolution.reset();
+        unfoldRemaining = unfoldLength.load();
+    }
+
+    int useTimeSlice() override
+    {
+        const auto version = requestedVersion.load();
+
+        // Nothing would play a composite, anything that changed meanwhile is built once folding is back on
+        if (! foldingPossible.load() || version == builtVersion
+             || juce::Time::getMillisecondCounter() - lastChangeTime.load() < settleTimeMs)
+            return 50;
+
+        ImpulseData::Ptr cab;
+        ToneCoefficients tone;
+
+        {
+            const juce::ScopedLock sl (cabLock);
+            cab = cabImpulse;
+        }
+
+        {
+            const juce::SpinLock::ScopedLockType sl (toneLock);
+            tone = toneCoefficients;
+        }
+
+        if (cab == nullptr || cab->sampleRate <= 0.0)
+            return 50;
+
+        juce::AudioBuffer<float> composite;
+        composite.makeCopyOf (cab->buffer);
+
+        const auto sampleRate = cab->sampleRate;
+        applyTone (composite, tone, sampleRate);
+
+        // The composite needs its whole length of input before its output is complete,
+        // the extra quarter second covers the convolution installing the new impulse
+        warmUpLength.store (composite.getNumSamples() + (int) (sampleRate * 0.25));
+        foldedConvolution.loadImpulseResponse (composite, sampleRate);
+
+        builtVersion = version;
+        readyVersion.store (version);
+        return 50;
+    }
+
+    /** Runs the impulse through the tone stages, long enough for their own ringing to die out. */
+    static void applyTone (juce::AudioBuffer<float>& impulse, const ToneCoefficients& tone, double sampleRate)
+    {
+        const auto cabLength = impulse.getNumSamples();
+        impulse.setSize (impulse.getNumChannels(), cabLength + (int) (sampleRate * 0.05), true, true);
+
+        for (int channel = 0; channel < impulse.getNumChannels(); ++channel)
+        {
+            auto* data = impulse.getWritePointer (channel);
+
+            for (const auto& c : tone)
+            {
+                double s1 = 0.0, s2 = 0.0;
+
+                for (int i = 0; i < impulse.getNumSamples(); ++i)
+                {
+                    const auto x = (double) data[i];
+                    const auto y = c[0] * x + s1;
+                    s1 = c[1] * x - c[3] * y + s2;
+                    s2 = c[2] * x - c[4] * y;
+                    data[i] = (float) y;
+                }
+            }
+        }
+
+        // Cut the tail where it drops under -100 dB of the peak, but never into the cab itself
+        const auto threshold = impulse.getMagnitude (0, impulse.getNumSamples()) * 1.0e-5f;
+        auto length = cabLength;
+
+        for (int channel = 0; channel < impulse.getNumChannels(); ++channel)
+        {
+            const auto* data = impulse.getReadPointer (channel);
+
+            for (int i = impulse.getNumSamples(); --i >= length;)
+            {
+                if (std::abs (data[i]) >= threshold)
+                {
+                    length = i + 1;
+                    break;
+                }
+            }
+        }
+
+        impulse.setSize (impulse.getNumChannels(), length, true);
+    }
+
+    CabConvolution foldedConvolution;
+    juce::AudioBuffer<float> foldedBuffer, cabBuffer;
+
+    // Audio thread only
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> mix;
+    int warmUpRemaining = -1, unfoldRemaining = -1;
+    bool runFolded = false, runUnfolded = true;
+    size_t blockRemaining = 0, nextBlockLength = 0;
+
+    std::atomic<int> requestedVersion { 0 }, readyVersion { -1 }, warmUpLength { 0 }, unfoldLength { 0 };
+    std::atomic<bool> foldingPossible { false };
+    std::atomic<juce::uint32> lastChangeTime { 0 };
+    int builtVersion = -1;
+
+    juce::CriticalSection cabLock;
+    ImpulseData::Ptr cabImpulse;
+
+    juce::SpinLock toneLock;
+    ToneCoefficients toneCoefficients;
+
+    juce::SharedResourcePointer<BuildThread> buildThread;
+
+    JUCE_DECLARE_NON_COPYABLE (FoldedCab)
+
+   #if JUCE_UNIT_TESTS
+    // Waits for composites, so the processors it compares fold on the same block
+    friend class ChainTilingTests;
+   #endif
+};
@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    ImpulseCache.h
+    Created: 17 Oct 2026 10:21:37pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ImpulseStore.h"
+
+//==============================================================================
+/** Resampled cab impulses kept on disk between sessions.
+
+    Each file holds one impulse exactly as CabImpulse::getResampled() made it,
+    a small header and then the channels as raw floats, so reading it back is
+    a memory map and no decoding, trimming or resampling. Entries are keyed by
+    the source file's path and modification time plus the target sample rate,
+    and an edited file leaves its old entries to be cleared out on the next write.
+    The header also keeps the hash of the source file's contents, so a cached
+    file can be found in the ImpulseStore without reading it.
+
+    Use it through a juce::SharedResourcePointer.
+*/
+class ImpulseCache
+{
+public:
+    /** The key for file as it is on disk right now. */
+    static juce::String getKey (const juce::File& file)
+    {
+        return getPathKey (file) + "_" + juce::String (file.getLastModificationTime().toMilliseconds());
+    }
+
+    /** The hash of the contents key's file was written with, at any sample rate, or empty if it isn't cached.
+        Anything cached decoded fine.
+    */
+    juce::String getContentKey (const juce::String& key) const
+    {
+        for (const auto& file : getFolder().findChildFiles (juce::File::findFiles, false, key + "_*" + suffix))
+        {
+            juce::FileInputStream in (file);
+            Header header;
+
+            if (in.openedOk() && in.read (&header, sizeof (Header)) == (int) sizeof (Header) && isValid (header))
+                return juce::String (header.contentKey, sizeof (header.contentKey));
+        }
+
+        return {};
+    }
+
+    /** Loading thread. The impulse for key at sampleRate, or nullptr if it isn't cached. */
+    ImpulseData::Ptr read (const juce::String& key, double sampleRate) const
+    {
+        const auto file = getFile (key, sampleRate);
+
+        if (! file.existsAsFile())
+            return nullptr;
+
+        auto mapping = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readOnly);
+        const auto* data = static_cast<const char*> (mapping->getData());
+
+        if (data == nullptr || mapping->getSize() < sizeof (Header))
+            return nullptr;
+
+        Header header;
+        std::memcpy (&header, data, sizeof (Header));
+
+        const auto numBytes = sizeof (Header) + sizeof (float) * (size_t) header.numChannels * (size_t) header.numSamples;
+
+        if (! isValid (header) || header.sampleRate != sampleRate || mapping->getSize() < numBytes)
+            return nullptr;
+
+        // Nothing writes to an impulse once it is built, so the buffer can point straight into the map
+        float* channels[maxChannels];
+
+        for (int channel = 0; channel < header.numChannels; ++channel)
+            channels[channel] = const_cast<float*> (reinterpret_cast<const float*> (data + sizeof (Header)) + channel * header.numSamples);
+
+        ImpulseData::Ptr impulse = new ImpulseData();
+        impulse->sampleRate = header.sampleRate;
+        impulse->buffer.setDataToReferTo (channels, header.numChannels, header.numSamples);
+        impulse->mapping = std::move (mapping);
+        return impulse;
+    }
+
+    /** Loading thread. Stores impulse under key, replacing anything cached for an older version of the file.
+        contentKey is the hash of the file's contents, getContentKey() hands it back.
+    */
+    void write (const juce::String& key, const juce::String& contentKey, const ImpulseData& impulse) const
+    {
+        const auto folder = getFolder();
+
+        if (! folder.createDirectory() || impulse.buffer.getNumChannels() > maxChannels
+             || contentKey.getNumBytesAsUTF8() > sizeof (Header::contentKey))
+            return;
+
+        const auto pathKey = key.upToLastOccurrenceOf ("_", false, false);
+
+        for (const auto& old : folder.findChildFiles (juce::File::findFiles, false, pathKey + "_*" + suffix))
+            if (! old.getFileName().startsWith (key + "_"))
+                old.deleteFile();
+
+        Header header;
+        std::memcpy (header.magic, magic, sizeof (header.magic));
+        header.version = version;
+        header.numChannels = impulse.buffer.getNumChannels();
+        header.numSamples = impulse.buffer.getNumSamples();
+        header.sampleRate = impulse.sampleRate;
+        std::memcpy (header.contentKey, contentKey.toRawUTF8(), contentKey.getNumBytesAsUTF8());
+
+        // Written to the side and moved into place, so a reader never maps half a file
+        juce::TemporaryFile temporary (getFile (key, impulse.sampleRate));
+
+        {
+            juce::FileOutputStream out (temporary.getFile());
+
+            if (! out.openedOk())
+                return;
+
+            out.write (&header, sizeof (Header));
+
+            for (int channel = 0; channel < header.numChannels; ++channel)
+                out.write (impulse.buffer.getReadPointer (channel), sizeof (float) * (size_t) header.numSamples);
+
+            if (out.getStatus().failed())
+                return;
+        }
+
+        temporary.overwriteTargetFileWithTemporary();
+    }
+
+private:
+    struct Header
+    {
+        char magic[4];
+        juce::int32 version, numChannels, numSamples;
+        double sampleRate;
+
+        // An MD5 in hex, not null terminated
+        char contentKey[32] = {};
+
+        // Keeps the samples after it 16 byte aligned
+        juce::int32 reserved[2] = { 0, 0 };
+    };
+
+    static constexpr const char* magic = "DAIR";
+    static constexpr const char* suffix = ".impulse";
+    // 2 is band limited and at juce::dsp::Convolution's level, 3 adds the content key, anything older is rebuilt
+    static constexpr juce::int32 version = 3;
+    static constexpr int maxChannels = 2;
+
+    static bool isValid (const Header& header) noexcept
+    {
+        return std::memcmp (header.magic, magic, sizeof (header.magic)) == 0 && header.version == version
+                && header.numChannels >= 1 && header.numChannels <= maxChannels && header.numSamples >= 1;
+    }
+
+    static juce::String getPathKey (const juce::File& file)
+    {
+        const auto path = file.getFullPathName();
+        return ImpulseStore::hash (path.toRawUTF8(), path.getNumBytesAsUTF8());
+    }
+
+    static juce::File getFolder()
+    {
+       #if JUCE_MAC
+        return juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory).getChildFile ("Application Support/DiodeAmplifier/Impulses");
+       #else
+        return juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory).getChildFile ("DiodeAmplifier/Impulses");
+       #endif
+    }
+
+    static juce::File getFile (const juce::String& key, double sampleRate)
+    {
+        return getFolder().getChildFile (key + "_" + juce::String (juce::roundToInt (sampleRate)) + suffix);
+    }
+};
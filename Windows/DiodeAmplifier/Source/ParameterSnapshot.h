@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    ParameterSnapshot.h
+    Created: 17 Oct 2026 5:47:03pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** Every parameter's value, read once per block.
+
+    The parameter ids are looked up once in attach(). After that update() is a
+    plain load of each raw value, and hands back a bit per parameter that moved
+    since the last block so only the affected DSP gets touched.
+*/
+template <typename Index, size_t numParameters>
+class ParameterSnapshot
+{
+public:
+    static_assert (numParameters <= 32, "The dirty bits only go up to 32 parameters");
+
+    /** Call once with the ids in Index order. */
+    void attach (juce::AudioProcessorValueTreeState& state, std::initializer_list<const char*> ids)
+    {
+        jassert (ids.size() == numParameters);
+
+        auto* source = sources.begin();
+
+        for (auto* id : ids)
+        {
+            *source = state.getRawParameterValue (id);
+            jassert (*source != nullptr);
+            ++source;
+        }
+
+        markAllDirty();
+    }
+
+    /** The next update() reports every parameter as changed, for prepareToPlay. */
+    void markAllDirty() noexcept
+    {
+        allDirty = true;
+    }
+
+    /** Audio thread. Loads every value and returns which ones changed. */
+    uint32_t update() noexcept
+    {
+        auto dirty = allDirty ? (uint32_t) ((1ull << numParameters) - 1) : 0u;
+        allDirty = false;
+
+        for (size_t i = 0; i < numParameters; ++i)
+        {
+            const auto value = sources[i]->load (std::memory_order_relaxed);
+
+            if (value != values[i])
+            {
+                values[i] = value;
+                dirty |= 1u << i;
+            }
+        }
+
+        return dirty;
+    }
+
+    float operator[] (Index index) const noexcept
+    {
+        return values[(size_t) index];
+    }
+
+    static bool hasChanged (uint32_t dirty, Index index) noexcept
+    {
+        return (dirty & (1u << (int) index)) != 0;
+    }
+
+private:
+    std::array<std::atomic<float>*, numParameters> sources {};
+    std::array<float, numParameters> values {};
+    bool allDirty = true;
+};
@@ -0,0 +1,739 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolution.h
+    Created: 17 Oct 2026 8:26:45pm
+    Author:  Landon Viator
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/** The tail of a long impulse, convolved in non-uniform FFT partitions.
+
+    The tail is cut into partitions that start at firstPartitionSize and double
+    as soon as they are twice their size into the impulse, up to maxPartitionSize,
+    so the part right after the head is cheap to get out on time and the long end
+    of the impulse runs in big, cheap per sample FFTs. Each run of equal sized
+    partitions is a uniformly partitioned overlap-save convolution with its own
+    frequency domain delay line.
+
+    A partition of size P has to start at least P taps in, its output for the next
+    P samples is worked out the moment the samples before them have arrived. There
+    is no latency as long as the taps in front of offset run somewhere else. With
+    latency samples of delay the whole impulse can start out in partitions of that size.
+
+    Every run after the first starts at least twice its size in, so its output can
+    be asked for a whole period early. The big ones are handed to a pool of worker
+    threads shared by every instance and picked up one period later, which keeps
+    their FFTs off the audio thread. The pool only runs while some tail has
+    partitions that big. The audio thread hands jobs over by adding to a counter,
+    which never takes a lock. One worker looks at it four times a shortest period
+    and wakes as many of the others as there are jobs, and each of them claims
+    jobs on its own, so the tails of every instance spread over the cores. If a
+    worker hasn't got to a job by then the audio thread runs it itself, and if
+    one is still part way through it the audio thread works the period out again
+    beside it rather than wait.
+
+    Only the audio thread writes the input spectra, and they keep one slot more than
+    there are partitions, so a late worker can go on reading for another period
+    while the next window goes in. A worker stalled for longer than that has its
+    segment drop out until it lets go, and start again from silence.
+*/
+class PartitionedConvolution
+{
+public:
+    static constexpr int maxPartitionSize = 4096;
+
+    // Anything smaller costs less to run inline than to hand over
+    static constexpr int minBackgroundPartitionSize = 1024;
+
+    ~PartitionedConvolution()
+    {
+        removeFromWorkers();
+    }
+
+    //==============================================================================
+    /** The partition spectra of an impulse. They never change once built, so every
+        tail running the same impulse can share them through an ImpulseStore.
+    */
+    struct Filter : public juce::ReferenceCountedObject
+    {
+        using Ptr = juce::ReferenceCountedObjectPtr<Filter>;
+
+        struct Segment
+        {
+            int size = 0, offset = 0, numPartitions = 0;
+            bool background = false;
+
+            // Per impulse channel, the spectrum of each partition
+            std::vector<float> spectra;
+
+            // Bins 0 to size of a 2 * size real FFT, interleaved real and imaginary
+            int getSpectrumLength() const noexcept { return (size + 1) * 2; }
+
+            const float* getSpectrum (int channel, int partition) const noexcept { return spectra.data() + (channel * numPartitions + partition) * getSpectrumLength(); }
+        };
+
+        std::vector<Segment> segments;
+        int numImpulseChannels = 1, firstSize = 1, lookback = 0;
+    };
+
+    /** Loading thread. Partitions the taps of impulse from offset onwards, delayed by latency samples. */
+    static Filter::Ptr createFilter (const juce::AudioBuffer<float>& impulse, int offset, int firstPartitionSize, int latency = 0)
+    {
+        jassert (juce::isPowerOfTwo (firstPartitionSize) && offset + latency >= firstPartitionSize);
+
+        Filter::Ptr filter = new Filter();
+        filter->numImpulseChannels = juce::jmax (1, impulse.getNumChannels());
+        filter->firstSize = firstPartitionSize;
+
+        // Partitions are placed by where their taps come out, latency samples after where they sit in the impulse
+        const auto end = impulse.getNumSamples() + latency;
+        auto size = firstPartitionSize;
+        auto start = offset + latency;
+
+        while (start < end)
+        {
+            const auto remaining = (end - start + size - 1) / size;
+            const auto numPartitions = size == maxPartitionSize ? remaining
+                                                                : juce::jmin (remaining, juce::jmax (1, (size * 4 - start) / size));
+
+            filter->segments.emplace_back();
+            auto& segment = filter->segments.back();
+            segment.size = size;
+            segment.offset = start;
+            segment.numPartitions = numPartitions;
+            segment.background = size >= minBackgroundPartitionSize && start >= size * 2;
+            segment.spectra.assign ((size_t) (filter->numImpulseChannels * numPartitions * segment.getSpectrumLength()), 0.0f);
+
+            juce::dsp::FFT fft (getOrder (size * 2));
+            std::vector<float> buffer ((size_t) size * 4);
+
+            for (int channel = 0; channel < filter->numImpulseChannels; ++channel)
+            {
+                for (int partition = 0; partition < numPartitions; ++partition)
+                {
+                    std::fill (buffer.begin(), buffer.end(), 0.0f);
+
+                    const auto first = start - latency + partition * size;
+                    const auto length = juce::jmin (size, impulse.getNumSamples() - first);
+
+                    for (int i = 0; i < length; ++i)
+                        buffer[(size_t) i] = impulse.getSample (juce::jmin (channel, impulse.getNumChannels() - 1), first + i);
+
+                    fft.performRealOnlyForwardTransform (buffer.data(), true);
+                    std::copy (buffer.begin(), buffer.begin() + segment.getSpectrumLength(),
+                               segment.spectra.begin() + (channel * numPartitions + partition) * segment.getSpectrumLength());
+                }
+            }
+
+            filter->lookback = juce::jmax (filter->lookback, start + size);
+            start += numPartitions * size;
+
+            if (size < maxPartitionSize && start >= size * 4)
+                size *= 2;
+        }
+
+        return filter;
+    }
+
+    /** Loading thread, allocates. Runs newFilter on numChannelsToProcess channels, keeping a reference to it.
+        sampleRate only sets how often the workers look for jobs.
+    */
+    void prepare (Filter::Ptr newFilter, int numChannelsToProcess, double sampleRate)
+    {
+        jassert (newFilter != nullptr);
+
+        // Waits for any job a worker is still running on the old partitions
+        removeFromWorkers();
+
+        segments.clear();
+        filter = std::move (newFilter);
+        numChannels = juce::jmax (1, numChannelsToProcess);
+        numImpulseChannels = filter->numImpulseChannels;
+        firstSize = filter->firstSize;
+
+        auto anyBackground = false;
+        shortestBackgroundSeconds = 0.0;
+
+        for (const auto& shared : filter->segments)
+        {
+            segments.push_back (std::make_unique<Segment>());
+            auto& segment = *segments.back();
+            segment.size = shared.size;
+            segment.offset = shared.offset;
+            segment.numPartitions = shared.numPartitions;
+            segment.background = shared.background;
+            segment.filter = &shared;
+            segment.numSlots = segment.numPartitions + 1;
+            segment.input.assign ((size_t) (numChannels * segment.numSlots * segment.getSpectrumLength()), 0.0f);
+            segment.local.allocate (segment.size, numChannels);
+
+            if (segment.background)
+            {
+                segment.job.allocate (segment.size, numChannels);
+
+                const auto seconds = segment.size / juce::jmax (1.0, sampleRate);
+                shortestBackgroundSeconds = anyBackground ? juce::jmin (shortestBackgroundSeconds, seconds) : seconds;
+                anyBackground = true;
+            }
+        }
+
+        const auto largest = segments.empty() ? firstSize : segments.back()->size;
+
+        inputRing.assign ((size_t) numChannels, std::vector<float> ((size_t) juce::nextPowerOfTwo (filter->lookback + 1), 0.0f));
+        outputRing.assign ((size_t) numChannels, std::vector<float> ((size_t) juce::nextPowerOfTwo (largest), 0.0f));
+        inputMask = juce::nextPowerOfTwo (filter->lookback + 1) - 1;
+        outputMask = juce::nextPowerOfTwo (largest) - 1;
+
+        reset();
+
+        // Only tails with work to hand over keep the pool, and its threads, running
+        if (anyBackground)
+        {
+            if (workers == nullptr)
+                workers = std::make_unique<juce::SharedResourcePointer<Workers>>();
+
+            (*workers)->add (this);
+        }
+        else
+        {
+            workers.reset();
+        }
+    }
+
+    /** Loading thread. Drops the partitions, and the reference to them, until the next prepare(). */
+    void release()
+    {
+        removeFromWorkers();
+        workers.reset();
+        segments.clear();
+        filter = nullptr;
+    }
+
+    bool isEmpty() const noexcept
+    {
+        return segments.empty();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& segment : segments)
+        {
+            auto state = (int) queued;
+
+            // Takes back a job no worker has started, one that's running gets its spectra cleared once it's done with them
+            if (! segment->state.compare_exchange_strong (state, idle) && state == running)
+            {
+                segment->needsClear = true;
+            }
+            else
+            {
+                segment->state.store (idle);
+                std::fill (segment->input.begin(), segment->input.end(), 0.0f);
+            }
+
+            segment->requested = nothing;
+            segment->current = 0;
+        }
+
+        for (auto& ring : inputRing)
+            std::fill (ring.begin(), ring.end(), 0.0f);
+
+        for (auto& ring : outputRing)
+            std::fill (ring.begin(), ring.end(), 0.0f);
+
+        position = 0;
+    }
+
+    /** Audio thread. Adds the tail's output for input onto output, one input pointer per output channel. */
+    void processAdding (const float* const* input, juce::dsp::AudioBlock<float>& output) noexcept
+    {
+        const auto channelsToProcess = juce::jmin ((int) output.getNumChannels(), numChannels);
+        const auto numSamples = (int) output.getNumSamples();
+
+        for (int done = 0; done < numSamples;)
+        {
+            const auto phase = (int) (position & (juce::uint32) (firstSize - 1));
+
+            if (phase == 0)
+                startPeriods (channelsToProcess);
+
+            const auto numToDo = juce::jmin (numSamples - done, firstSize - phase);
+
+            for (int channel = 0; channel < channelsToProcess; ++channel)
+            {
+                auto& in = inputRing[(size_t) channel];
+                auto& out = outputRing[(size_t) channel];
+                auto* destination = output.getChannelPointer ((size_t) channel) + done;
+
+                for (int i = 0; i < numToDo; ++i)
+                {
+                    const auto index = position + (juce::uint32) i;
+                    in[index & (juce::uint32) inputMask] = input[channel][done + i];
+                    destination[i] += out[index & (juce::uint32) outputMask];
+                    out[index & (juce::uint32) outputMask] = 0.0f;
+                }
+            }
+
+            position += (juce::uint32) numToDo;
+            done += numToDo;
+        }
+    }
+
+private:
+    enum JobState { idle, queued, running, finished };
+    enum Request { nothing, onWorker, onAudioThread };
+
+    /** One period's worth of convolution, the window going in and what comes out of it. */
+    struct Job
+    {
+        // The input slot the window's spectrum goes into
+        int slot = 0, numChannels = 0;
+
+        // Per channel, the 2 * size input window, its spectrum and the size samples coming out
+        std::vector<float> window, spectrum, result;
+        std::vector<float> fftBuffer, accumulator;
+
+        // Its own, so a late job and the same one run again don't share any scratch
+        std::unique_ptr<juce::dsp::FFT> fft;
+
+        void allocate (int size, int channels)
+        {
+            fft = std::make_unique<juce::dsp::FFT> (getOrder (size * 2));
+            window.assign ((size_t) (channels * size * 2), 0.0f);
+            spectrum.assign ((size_t) (channels * (size + 1) * 2), 0.0f);
+            result.assign ((size_t) (channels * size), 0.0f);
+            fftBuffer.assign ((size_t) size * 4, 0.0f);
+            accumulator.assign ((size_t) size * 4, 0.0f);
+        }
+    };
+
+    struct Segment
+    {
+        int size = 0, offset = 0, numPartitions = 0, numSlots = 0, current = 0;
+        bool background = false;
+
+        // The shared spectra this segment runs
+        const Filter::Segment* filter = nullptr;
+
+        // Per channel, the spectra of the last numSlots input windows, current is the newest
+        std::vector<float> input;
+
+        // Whoever moves the job from queued to running owns it until it is finished
+        Job job;
+        std::atomic<int> state { idle };
+
+        // Audio thread only. The job it runs itself, what was asked for the coming period,
+        // the slot of a job a worker was too late with, and whether the spectra need clearing
+        Job local;
+        Request requested = nothing;
+        int lateSlot = 0;
+        bool needsClear = false;
+
+        // Bins 0 to size of a 2 * size real FFT, interleaved real and imaginary
+        int getSpectrumLength() const noexcept { return (size + 1) * 2; }
+
+        const float* getFilter (int channel, int partition) const noexcept { return filter->getSpectrum (channel, partition); }
+        float* getInput (int channel, int slot) noexcept { return input.data() + (channel * numSlots + slot) * getSpectrumLength(); }
+        const float* getInput (int channel, int slot) const noexcept { return input.data() + (channel * numSlots + slot) * getSpectrumLength(); }
+    };
+
+    //==============================================================================
+    /** Worker threads shared by every tail with background partitions. */
+    struct Workers
+    {
+        // As high as it goes without being a realtime thread, those are the host's
+        static constexpr int workerPriority = 9;
+
+        // A job is asked for a period before it's due, looking four times a period leaves the
+        // worker at least three quarters of it. Never more often than every millisecond
+        static constexpr int pollsPerPeriod = 4, minPollMilliseconds = 1, maxPollMilliseconds = 20;
+
+        Workers()
+        {
+            // The first one looks for jobs, the rest sleep until it finds more than it can run
+            for (int i = juce::jlimit (1, 4, juce::SystemStats::getNumCpus() - 1); --i >= 0;)
+                threads.add (new Worker (*this, threads.isEmpty()));
+
+            // Only once they're all there, the first one wakes the others through the array
+            for (auto* thread : threads)
+                thread->startThread (workerPriority);
+        }
+
+        ~Workers()
+        {
+            for (auto* thread : threads)
+            {
+                thread->signalThreadShouldExit();
+                thread->notify();
+            }
+
+            for (auto* thread : threads)
+                thread->stopThread (1000);
+        }
+
+        void add (PartitionedConvolution* tail)
+        {
+            const juce::ScopedWriteLock sl (lock);
+            tails.addIfNotAlreadyThere (tail);
+            updatePollInterval();
+        }
+
+        /** Once this returns no worker is touching tail. */
+        void remove (PartitionedConvolution* tail)
+        {
+            const juce::ScopedWriteLock sl (lock);
+            tails.removeFirstMatchingValue (tail);
+            updatePollInterval();
+        }
+
+        /** Audio thread, lock free. */
+        void jobsQueued (int numJobs) noexcept
+        {
+            numQueued.fetch_add (numJobs);
+        }
+
+        /** Claims and runs one queued job, false if there weren't any. Other workers can be in here at the same time. */
+        bool runQueuedJob()
+        {
+            const juce::ScopedReadLock sl (lock);
+
+            for (auto* tail : tails)
+                for (auto& segment : tail->segments)
+                    if (segment->background && tail->tryRunJob (*segment))
+                        return true;
+
+            return false;
+        }
+
+        void updatePollInterval()
+        {
+            auto shortest = 1.0;
+
+            for (auto* tail : tails)
+                shortest = juce::jmin (shortest, tail->shortestBackgroundSeconds);
+
+            pollMilliseconds.store (juce::jlimit (minPollMilliseconds, maxPollMilliseconds,
+                                                  (int) (shortest * 1000.0 / pollsPerPeriod)));
+        }
+
+        struct Worker : public juce::Thread
+        {
+            Worker (Workers& w, bool looksForJobs) : juce::Thread ("Convolution tail"), owner (w), poller (looksForJobs) {}
+
+            void run() override
+            {
+                while (! threadShouldExit())
+                {
+                    if (poller)
+                    {
+                        const auto queued = owner.numQueued.exchange (0);
+
+                        if (queued <= 0)
+                        {
+                            wait (owner.pollMilliseconds.load());
+                            continue;
+                        }
+
+                        // One job each, this one takes the first
+                        for (int i = 1; i < juce::jmin (queued, owner.threads.size()); ++i)
+                            owner.threads.getUnchecked (i)->notify();
+                    }
+                    else
+                    {
+                        wait (-1);
+                    }
+
+                    // A job can be taken back by the audio thread or claimed by another worker, the count is only a hint
+                    while (! threadShouldExit() && owner.runQueuedJob())
+                    {
+                    }
+                }
+            }
+
+            Workers& owner;
+            const bool poller;
+        };
+
+        juce::ReadWriteLock lock;
+        juce::Array<PartitionedConvolution*> tails;
+        std::atomic<int> numQueued { 0 }, pollMilliseconds { maxPollMilliseconds };
+        juce::OwnedArray<Worker> threads;
+    };
+
+    void removeFromWorkers()
+    {
+        if (workers != nullptr)
+            (*workers)->remove (this);
+    }
+
+    static int getOrder (int fftSize) noexcept
+    {
+        auto order = 0;
+
+        while ((1 << order) < fftSize)
+            ++order;
+
+        return order;
+    }
+
+    /** Audio thread, at the start of every firstSize samples. */
+    void startPeriods (int channelsToProcess) noexcept
+    {
+        auto numQueued = 0;
+
+        for (auto& segmentPointer : segments)
+        {
+            auto& segment = *segmentPointer;
+
+            if ((position & (juce::uint32) (segment.size - 1)) != 0)
+                continue;
+
+            if (! segment.background)
+            {
+                // The window ending size samples past offset lines up with the next size outputs
+                gatherWindow (segment, segment.local, position - (juce::uint32) (segment.offset + segment.size), channelsToProcess);
+                convolve (segment, segment.local);
+                commit (segment, segment.local);
+                scatterResult (segment, segment.local);
+                continue;
+            }
+
+            // This period's output was asked for a period ago
+            if (auto* job = collectJob (segment))
+                scatterResult (segment, *job);
+
+            // Ask for the next period's, its window ends size samples later
+            if (requestJob (segment, channelsToProcess))
+                ++numQueued;
+        }
+
+        if (numQueued > 0)
+        {
+            jassert (workers != nullptr);
+            (*workers)->jobsQueued (numQueued);
+        }
+    }
+
+    void gatherWindow (const Segment& segment, Job& job, juce::uint32 windowStart, int channelsToProcess) noexcept
+    {
+        job.numChannels = channelsToProcess;
+        job.slot = (segment.current + 1) % segment.numSlots;
+
+        for (int channel = 0; channel < channelsToProcess; ++channel)
+        {
+            const auto& ring = inputRing[(size_t) channel];
+            auto* window = job.window.data() + channel * segment.size * 2;
+
+            for (int i = 0; i < segment.size * 2; ++i)
+                window[i] = ring[(windowStart + (juce::uint32) i) & (juce::uint32) inputMask];
+        }
+    }
+
+    void scatterResult (const Segment& segment, const Job& job) noexcept
+    {
+        for (int channel = 0; channel < job.numChannels; ++channel)
+        {
+            auto& out = outputRing[(size_t) channel];
+            const auto* result = job.result.data() + channel * segment.size;
+
+            for (int i = 0; i < segment.size; ++i)
+                out[(position + (juce::uint32) i) & (juce::uint32) outputMask] += result[i];
+        }
+    }
+
+    /** Audio thread. The job with this period's output, taken from a worker or run here. Never waits. */
+    Job* collectJob (Segment& segment) noexcept
+    {
+        const auto requested = segment.requested;
+        segment.requested = nothing;
+
+        if (segment.needsClear)
+        {
+            if (segment.state.load() == running)
+                return nullptr;
+
+            segment.state.store (idle);
+            std::fill (segment.input.begin(), segment.input.end(), 0.0f);
+            segment.needsClear = false;
+            return nullptr;
+        }
+
+        if (requested == onWorker)
+        {
+            auto state = (int) queued;
+
+            // Nobody has started it, so it runs here
+            if (segment.state.compare_exchange_strong (state, running))
+            {
+                convolve (segment, segment.job);
+                state = finished;
+            }
+
+            if (state == finished)
+            {
+                segment.state.store (idle);
+                commit (segment, segment.job);
+                return &segment.job;
+            }
+
+            // A worker is part way through it, it gets run again here from the same window
+            segment.lateSlot = segment.job.slot;
+            segment.local.slot = segment.job.slot;
+            segment.local.numChannels = segment.job.numChannels;
+            std::copy (segment.job.window.begin(), segment.job.window.end(), segment.local.window.begin());
+        }
+        else if (requested != onAudioThread)
+        {
+            return nullptr;
+        }
+
+        // The late worker reads the slots before its own, this one can only go in its own or the one after
+        if (segment.state.load() == running
+             && segment.local.slot != segment.lateSlot
+             && segment.local.slot != (segment.lateSlot + 1) % segment.numSlots)
+        {
+            segment.needsClear = true;
+            return nullptr;
+        }
+
+        convolve (segment, segment.local);
+        commit (segment, segment.local);
+        return &segment.local;
+    }
+
+    /** Audio thread. Hands the next period to the workers, unless one of them still has the last job. */
+    bool requestJob (Segment& segment, int channelsToProcess) noexcept
+    {
+        if (segment.needsClear)
+            return false;
+
+        // A finished job left here is one that came too late and got run again
+        auto state = segment.state.load();
+
+        if (state == finished)
+        {
+            segment.state.store (idle);
+            state = idle;
+        }
+
+        const auto windowStart = position - (juce::uint32) segment.offset;
+
+        if (state != idle)
+        {
+            gatherWindow (segment, segment.local, windowStart, channelsToProcess);
+            segment.requested = onAudioThread;
+            return false;
+        }
+
+        gatherWindow (segment, segment.job, windowStart, channelsToProcess);
+        segment.requested = onWorker;
+        segment.state.store (queued);
+        return true;
+    }
+
+    bool tryRunJob (Segment& segment) noexcept
+    {
+        auto state = (int) queued;
+
+        if (! segment.state.compare_exchange_strong (state, running))
+            return false;
+
+        convolve (segment, segment.job);
+        segment.state.store (finished);
+        return true;
+    }
+
+    /** Audio thread. Makes the job's spectrum the newest input. */
+    static void commit (Segment& segment, const Job& job) noexcept
+    {
+        for (int channel = 0; channel < job.numChannels; ++channel)
+        {
+            const auto* spectrum = job.spectrum.data() + channel * segment.getSpectrumLength();
+            std::copy (spectrum, spectrum + segment.getSpectrumLength(), segment.getInput (channel, job.slot));
+        }
+
+        segment.current = job.slot;
+    }
+
+    /** Overlap-save of the job's window with the inputs before it. Only reads the segment, so a
+        late job and the same one run again can both go at once. */
+    void convolve (const Segment& segment, Job& job) const noexcept
+    {
+        const auto size = segment.size;
+        const auto spectrumLength = segment.getSpectrumLength();
+        auto& fftBuffer = job.fftBuffer;
+        auto& accumulator = job.accumulator;
+
+        for (int channel = 0; channel < job.numChannels; ++channel)
+        {
+            const auto* window = job.window.data() + channel * size * 2;
+            std::copy (window, window + size * 2, fftBuffer.begin());
+
+            job.fft->performRealOnlyForwardTransform (fftBuffer.data(), true);
+
+            auto* spectrum = job.spectrum.data() + channel * spectrumLength;
+            std::copy (fftBuffer.begin(), fftBuffer.begin() + spectrumLength, spectrum);
+
+            // A mono impulse runs on every channel
+            const auto impulseChannel = juce::jmin (channel, numImpulseChannels - 1);
+            std::fill (accumulator.begin(), accumulator.end(), 0.0f);
+
+            multiplyAccumulate (accumulator.data(), spectrum, segment.getFilter (impulseChannel, 0), size + 1);
+
+            for (int partition = 1; partition < segment.numPartitions; ++partition)
+            {
+                const auto slot = (job.slot - partition + segment.numSlots) % segment.numSlots;
+                multiplyAccumulate (accumulator.data(), segment.getInput (channel, slot), segment.getFilter (impulseChannel, partition), size + 1);
+            }
+
+            // The negative frequencies mirror the positive ones for a real signal
+            for (int bin = size + 1; bin < size * 2; ++bin)
+            {
+                accumulator[(size_t) bin * 2] = accumulator[(size_t) (size * 2 - bin) * 2];
+                accumulator[(size_t) bin * 2 + 1] = -accumulator[(size_t) (size * 2 - bin) * 2 + 1];
+            }
+
+            job.fft->performRealOnlyInverseTransform (accumulator.data());
+
+            // The second half is the part the circular wrap didn't touch
+            std::copy (accumulator.begin() + size, accumulator.begin() + size * 2, job.result.begin() + channel * size);
+        }
+    }
+
+    static void multiplyAccumulate (float* destination, const float* a, const float* b, int numBins) noexcept
+    {
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            const auto re = a[bin * 2] * b[bin * 2] - a[bin * 2 + 1] * b[bin * 2 + 1];
+            const auto im = a[bin * 2] * b[bin * 2 + 1] + a[bin * 2 + 1] * b[bin * 2];
+            destination[bin * 2] += re;
+            destination[bin * 2 + 1] += im;
+        }
+    }
+
+    Filter::Ptr filter;
+    std::vector<std::unique_ptr<Segment>> segments;
+    int numChannels = 1, numImpulseChannels = 1, firstSize = 1;
+
+    // The shortest time a worker has for a job, read by the workers under their lock
+    double shortestBackgroundSeconds = 0.0;
+
+    std::vector<std::vector<float>> inputRing, outputRing;
+    int inputMask = 0, outputMask = 0;
+    juce::uint32 position = 0;
+
+    // Only held while there are background segments, so impulses that never need the workers don't start them
+    std::unique_ptr<juce::SharedResourcePointer<Workers>> workers;
+
+   #if JUCE_UNIT_TESTS
+    // Holds the workers off and stalls jobs, to force the audio thread's fallbacks
+    friend class ConvolutionTests;
+   #endif
+};
@@ -15,7 +15,7 @@
 //==============================================================================
 /**
 */
-class DiodeAmplifierAudioProcessorEditor  : public juce::AudioProcessorEditor
+class DiodeAmplifierAudioProcessorEditor  : public juce::AudioProcessorEditor, private juce::Timer
 {
 public:
     DiodeAmplifierAudioProcessorEditor (DiodeAmplifierAudioProcessor&);
@@ -24,6 +24,9 @@ public:
     //==============================================================================
     void paint (juce::Graphics&) override;
     void resized() override;
+    
+    // Polls the factor the clipper is running at
+    void timerCallback() override;
 
 private:
     
@@ -69,6 +72,9 @@ private:
     juce::ComboBox mSampleMenu;
     std::unique_ptr <juce::AudioProcessorValueTreeState::ComboBoxAttachment> mSampleMenuAttach;
     
+    // Oversampling meter, what Auto has picked
+    juce::Label oversamplingMeter;
+    
     juce::AlertWindow settingsDialog {"Settings Window",
             "Congrats, you opened the window, but it doesn't do anything", juce::AlertWindow::AlertIconType::InfoIcon};
     
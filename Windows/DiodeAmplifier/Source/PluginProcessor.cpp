@@ -24,15 +24,11 @@ treeState (*this, nullptr, "PARAMETER", createParameterLayout())
 
 #endif
 {
-    treeState.addParameterListener (inputGainSliderId, this);
-    treeState.addParameterListener (driveSliderId, this);
-    treeState.addParameterListener (lowSliderId, this);
-    treeState.addParameterListener (midSliderId, this);
-    treeState.addParameterListener (highSliderId, this);
-    treeState.addParameterListener (outputGainSliderId, this);
-    treeState.addParameterListener (brightId, this);
     treeState.addParameterListener (cabId, this);
-    treeState.addParameterListener (menuId, this);
+    treeState.addParameterListener (cabLatencyId, this);
+    
+    parameterSnapshot.attach(treeState, {inputGainSliderId, driveSliderId, lowSliderId, midSliderId, highSliderId, outputGainSliderId,
+        brightId, cabId, menuId, oversamplingFilterId, clipperModeId, foldEqId});
     
     variableTree = {
             
@@ -50,32 +46,20 @@ treeState (*this, nullptr, "PARAMETER", createParameterLayout())
     
     variableTree.setProperty("cabOffGain", -16.0, nullptr);
     
-    convolutionProcessor.loadImpulseResponse
-    (BinaryData::metalOne_wav,
-     BinaryData::metalOne_wavSize,
-     juce::dsp::Convolution::Stereo::yes,
-     juce::dsp::Convolution::Trim::yes, 0,
-     juce::dsp::Convolution::Normalise::yes);
-    
+    resetCabImpulse();
 }
 
 DiodeAmplifierAudioProcessor::~DiodeAmplifierAudioProcessor()
 {
-    treeState.removeParameterListener (inputGainSliderId, this);
-    treeState.removeParameterListener (driveSliderId, this);
-    treeState.removeParameterListener (lowSliderId, this);
-    treeState.removeParameterListener (midSliderId, this);
-    treeState.removeParameterListener (highSliderId, this);
-    treeState.removeParameterListener (outputGainSliderId, this);
-    treeState.removeParameterListener (brightId, this);
+    cancelPendingUpdate();
     treeState.removeParameterListener (cabId, this);
-    treeState.removeParameterListener (menuId, this);
+    treeState.removeParameterListener (cabLatencyId, this);
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout DiodeAmplifierAudioProcessor::createParameterLayout()
 {
     std::vector <std::unique_ptr<juce::RangedAudioParameter>> params;
-    params.reserve(8);
+    params.reserve(13);
     
     auto inputGainParam = std::make_unique<juce::AudioParameterFloat>(inputGainSliderId, inputGainSliderName, -24.0f, 24.0f, 0.0f);
     auto driveParam = std::make_unique<juce::AudioParameterFloat>(driveSliderId, driveSliderName, 0.0f, 10.0f, 0.0f);
@@ -85,7 +69,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout DiodeAmplifierAudioProcessor
     auto outputGainParam = std::make_unique<juce::AudioParameterFloat>(outputGainSliderId, outputGainSliderName, -24.0f, 24.0f, 0.0f);
     auto brightParam = std::make_unique<juce::AudioParameterBool>(brightId, brightName, false);
     auto cabParam = std::make_unique<juce::AudioParameterBool>(cabId, cabName, true);
-    auto pMenu = std::make_unique<juce::AudioParameterInt>(menuId, menuName, 0, 1, 0);
+    auto pMenu = std::make_unique<juce::AudioParameterChoice>(menuId, menuName, juce::StringArray {"1x", "2x", "4x", "8x", "Auto"}, 0);
+    auto oversamplingFilterParam = std::make_unique<juce::AudioParameterChoice>(oversamplingFilterId, oversamplingFilterName, juce::StringArray {"IIR", "FIR"}, 0);
+    auto clipperModeParam = std::make_unique<juce::AudioParameterChoice>(clipperModeId, clipperModeName, juce::StringArray {"Curve", "Table", "ADAA 1st", "ADAA 2nd"}, 0);
+    auto foldEqParam = std::make_unique<juce::AudioParameterBool>(foldEqId, foldEqName, false);
+    auto cabLatencyParam = std::make_unique<juce::AudioParameterChoice>(cabLatencyId, cabLatencyName, juce::StringArray {"0", "256", "512", "1024"}, 0);
 
     params.push_back(std::move(inputGainParam));
     params.push_back(std::move(driveParam));
@@ -96,68 +84,84 @@ juce::AudioProcessorValueTreeState::ParameterLayout DiodeAmplifierAudioProcessor
     params.push_back(std::move(brightParam));
     params.push_back(std::move(cabParam));
     params.push_back(std::move(pMenu));
+    params.push_back(std::move(oversamplingFilterParam));
+    params.push_back(std::move(clipperModeParam));
+    params.push_back(std::move(foldEqParam));
+    
+    // Newest last, hosts that address parameters by index keep finding the older ones where they were
+    params.push_back(std::move(cabLatencyParam));
 
     return { params.begin(), params.end() };
 }
 
 void DiodeAmplifierAudioProcessor::parameterChanged(const juce::String &parameterID, float newValue)
 {
-    if (parameterID == inputGainSliderId)
-        {
-            inputGainProcessor.setGainDecibels(newValue);
-        }
+    // The dsp reads its parameters in updateParameters. The output gain swaps with the cab, but setting
+    // a parameter and the variable tree can't happen on whatever thread the host automates from
+    if (parameterID == cabId)
+        triggerAsyncUpdate();
     
-    else if (parameterID == lowSliderId)
-        {
-            updateLowFilter(newValue);
-        }
+    // A different latency means new partitions, too much work for whatever thread the host automates from
+    if (parameterID == cabLatencyId)
+        setCabLatency((int) newValue);
+}
+
+void DiodeAmplifierAudioProcessor::handleAsyncUpdate()
+{
+    const auto cabOn = *treeState.getRawParameterValue(cabId) != 0;
     
-    else if (parameterID == midSliderId)
-        {
-            updateMidFilter(newValue);
-        }
+    // Switched back before this got to run, the output gain already goes with it
+    if (outputGainCabOn.exchange(cabOn) == cabOn)
+        return;
     
-    else if (parameterID == highSliderId)
-        {
-            updateHighFilter(newValue);
-        }
+    if (cabOn)
+    {
+        // Whatever the output was set to with the cab off is what to go back to later
+        variableTree.setProperty("cabOffGain", (double) *treeState.getRawParameterValue(outputGainSliderId), nullptr);
+        treeState.getParameterAsValue(outputGainSliderId) = 0.0;
+    }
     
-    else if (parameterID == outputGainSliderId)
-        {
-            outputGainProcessor.setGainDecibels(newValue);
-            
-            if (!convolutionToggle) variableTree.setProperty("cabOffGain", newValue, nullptr);
-        }
+    else
+    {
+        treeState.getParameterAsValue(outputGainSliderId) = variableTree.getProperty("cabOffGain", -16.0);
+    }
+}
+
+void DiodeAmplifierAudioProcessor::updateParameters()
+{
+    const auto dirty = parameterSnapshot.update();
     
-    else if (parameterID == driveSliderId)
-        {
-            driveScaled = pow(10.0f, newValue * 0.25f);
-        }
+    if (dirty == 0) return;
     
-    else if (parameterID == brightId)
-        {
-            *highNotchFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(lastSampleRate, 4000.0f, 1.0f, pow(10.0f, -12.0f / 20.0f) * (newValue + 1));
-
-        }
-    else if (parameterID == cabId)
-        {
-            convolutionToggle = newValue;
-            
-            if (newValue == 0)
-            {
-                treeState.getParameterAsValue(outputGainSliderId) = variableTree.getProperty("cabOffGain");
-                DBG(variableTree.getProperty("cabOffGain").toString());
-            }
-            
-            else
-            {
-                treeState.getParameterAsValue(outputGainSliderId) = 0.0;
-            }
-        }
-    else if (parameterID == menuId)
-        {
-            oversamplingToggle = newValue;
-        }
+    const auto changed = [dirty](ParameterIndex index) { return ParameterSnapshot<ParameterIndex, numParameterIndices>::hasChanged(dirty, index); };
+    
+    if (changed(inputGainIndex)) forEachChain([this](auto& chain) { chain.inputGain.setTargetValue(juce::Decibels::decibelsToGain(parameterSnapshot[inputGainIndex])); });
+    
+    if (changed(driveIndex))
+    {
+        driveScaled = pow(10.0f, parameterSnapshot[driveIndex] * 0.25f);
+        clipperTables.setDrive(driveScaled);
+        smoothedDrive.setTargetValue(driveScaled);
+    }
+    
+    if (changed(lowIndex)) updateLowFilter(parameterSnapshot[lowIndex]);
+    if (changed(midIndex)) updateMidFilter(parameterSnapshot[midIndex]);
+    if (changed(highIndex)) updateHighFilter(parameterSnapshot[highIndex]);
+    if (changed(outputGainIndex)) forEachChain([this](auto& chain) { chain.outputGain.setTargetValue(juce::Decibels::decibelsToGain(parameterSnapshot[outputGainIndex])); });
+    
+    if (changed(brightIndex))
+    {
+        updateToneFilter(highNotchFilter, BiquadDesign::makePeakFilter(projectSampleRate, 4000.0f, 1.0f, pow(10.0f, -12.0f / 20.0f) * (parameterSnapshot[brightIndex] + 1)));
+    }
+    
+    convolutionToggle.store(parameterSnapshot[cabIndex] != 0);
+    oversamplingChoice = parameterSnapshot[oversamplingIndex];
+    oversamplingFilter = parameterSnapshot[oversamplingFilterIndex];
+    clipperMode = parameterSnapshot[clipperModeIndex];
+    foldEq = parameterSnapshot[foldEqIndex];
+    
+    // Only worth building composites while they could be played
+    foldedCab.setFoldingEnabled(foldEq && convolutionToggle);
 }
 
 //==============================================================================
@@ -195,7 +199,7 @@ bool DiodeAmplifierAudioProcessor::isMidiEffect() const
 
 double DiodeAmplifierAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return filterTailSeconds + (convolutionToggle.load() ? cabLoader.getTailSeconds() : 0.0);
 }
 
 int DiodeAmplifierAudioProcessor::getNumPrograms()
@@ -228,52 +232,85 @@ void DiodeAmplifierAudioProcessor::prepareToPlay (double sampleRate, int samples
     // Initialize spec for dsp modules
     juce::dsp::ProcessSpec spec;
     spec.maximumBlockSize = samplesPerBlock;
-    spec.sampleRate = sampleRate * oversamplingProcessor.getOversamplingFactor();
+    spec.sampleRate = sampleRate;
     spec.numChannels = getTotalNumOutputChannels();
     
-    // Set the sample rate and use it for dsp modules
-    // We need both samplerates to switch between oversampling states
-    lastSampleRate = spec.sampleRate;
+    // Every stage is designed at the host rate, the clipper's oversampling is handled inside processChain
     projectSampleRate = sampleRate;
     
-    highPassFilter.prepare(spec);
-    highPassFilter.reset();
-    *highPassFilter.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(projectSampleRate, 200);
+    updatePreClipFilters();
 
-    preClipFilter.prepare(spec);
-    preClipFilter.reset();
-    *preClipFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(projectSampleRate, 1420, 0.5, 6.0);
+    convolutionProcessor.prepare(spec);
+    foldedCab.prepare(spec);
     
-    lowFilter.prepare(spec);
-    lowFilter.reset();
-    *lowFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf(projectSampleRate, 200, 1.3, pow(10, *treeState.getRawParameterValue(lowSliderId) * 0.05));
-
-    midFilter.prepare(spec);
-    midFilter.reset();
-    *midFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(projectSampleRate, 815, 0.3, pow(10, *treeState.getRawParameterValue(midSliderId) * 0.05));
-
-    highFilter.prepare(spec);
-    highFilter.reset();
-    *highFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(projectSampleRate, 6000, 0.2, pow(10, *treeState.getRawParameterValue(highSliderId) * 0.05));
-
-    highNotchFilter.prepare(spec);
-    highNotchFilter.reset();
-    *highNotchFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(projectSampleRate, 4000.0f, 1.0f, pow(10.0f, -12.0f / 20.0f) * (*treeState.getRawParameterValue(brightId) + 1));
+    // The cab keeps playing what it has, and is only rebuilt if the rate, block size or latency changed
+    setCabLatency((int) *treeState.getRawParameterValue(cabLatencyId));
+    cabLoader.prepare(spec);
     
+    // Pick up every parameter at the new rate
+    parameterSnapshot.markAllDirty();
+    updateParameters();
     
-    inputGainProcessor.prepare(spec);
-    inputGainProcessor.reset();
-    inputGainProcessor.setGainDecibels(*treeState.getRawParameterValue(inputGainSliderId));
+    smoothedDrive.prepare(sampleRate, samplesPerBlock * 8);
+    smoothedDrive.setCurrentAndTargetValue(driveScaled);
+    transitionDrive.prepare(sampleRate, samplesPerBlock * 8);
+        
+    clipperTables.prepare(driveScaled);
+    antiderivativeClipper.prepare(spec.numChannels);
+    transitionClipper.prepare(spec.numChannels);
     
-    outputGainProcessor.prepare(spec);
-    outputGainProcessor.reset();
-    outputGainProcessor.setGainDecibels(*treeState.getRawParameterValue(outputGainSliderId));
+    // Only the chain for the precision the host renders in is needed
+    if (isUsingDoublePrecision())
+        prepareChain(doubleChain, spec);
+    else
+        prepareChain(floatChain, spec);
+}
 
-    convolutionProcessor.prepare(spec);
+template <typename SampleType>
+void DiodeAmplifierAudioProcessor::prepareChain(DspChain<SampleType>& chain, const juce::dsp::ProcessSpec& spec)
+{
+    chain.preClipFilters.prepare(spec);
+    chain.toneFilters.prepare(spec);
+    
+    // Preparing after updateParameters starts the gains at their values rather than ramping up to them
+    chain.inputGain.reset(spec.sampleRate, SmoothedDrive::rampSeconds);
+    chain.outputGain.reset(spec.sampleRate, SmoothedDrive::rampSeconds);
     
-    convolutionToggle = *treeState.getRawParameterValue(cabId);
+    for (size_t i = 0; i < chain.oversamplingProcessors.size(); ++i)
+    {
+        const auto filterType = i < 3 ? juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR
+                                      : juce::dsp::Oversampling<SampleType>::filterHalfBandFIREquiripple;
         
-    driveScaled = pow(10.0f, *treeState.getRawParameterValue(driveSliderId) * 0.25f);
+        chain.oversamplingProcessors[i] = std::make_unique<juce::dsp::Oversampling<SampleType>>(spec.numChannels, i % 3 + 1, filterType);
+        chain.oversamplingProcessors[i]->initProcessing(spec.maximumBlockSize);
+    }
+    
+    // Auto runs the lower factors a tile at a time next to the one it's leaving, delayed to line up with 8x
+    const auto maxAlignment = juce::jmax(chain.oversamplingProcessors[2]->getLatencyInSamples(), chain.oversamplingProcessors[5]->getLatencyInSamples());
+    chain.adaptive.alignment.setMaximumDelayInSamples((int) std::ceil(maxAlignment) + 4);
+    chain.adaptive.alignment.prepare({spec.sampleRate, (juce::uint32) maxTileSize, spec.numChannels});
+    chain.adaptive.incomingBuffer.setSize((int) spec.numChannels, (int) maxTileSize);
+    chain.adaptive.running = false;
+    
+    chain.activeOversamplingProcessor = getReportedOversamplingProcessor(chain);
+    reportLatency(chain);
+}
+
+template <typename SampleType>
+juce::dsp::Oversampling<SampleType>* DiodeAmplifierAudioProcessor::getReportedOversamplingProcessor(DspChain<SampleType>& chain)
+{
+    // Auto reports the latency of 8x whatever factor it's on
+    const auto choice = juce::jlimit(0, numOversamplingChoices - 1, oversamplingChoice);
+    return getOversamplingProcessor(chain, choice == autoOversamplingChoice ? autoOversamplingChoice - 1 : choice);
+}
+
+template <typename SampleType>
+void DiodeAmplifierAudioProcessor::reportLatency(DspChain<SampleType>& chain)
+{
+    if (auto* oversamplingProcessor = getReportedOversamplingProcessor(chain))
+        updateLatency((double) oversamplingProcessor->getLatencyInSamples(), (int) oversamplingProcessor->getOversamplingFactor());
+    else
+        updateLatency(0.0, 1);
 }
 
 void DiodeAmplifierAudioProcessor::releaseResources()
@@ -307,6 +344,22 @@ bool DiodeAmplifierAudioProcessor::isBusesLayoutSupported (const BusesLayout& la
 #endif
 
 void DiodeAmplifierAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples(buffer, floatChain);
+}
+
+void DiodeAmplifierAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples(buffer, doubleChain);
+}
+
+bool DiodeAmplifierAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template <typename SampleType>
+void DiodeAmplifierAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer, DspChain<SampleType>& chain)
 {
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -315,68 +368,429 @@ void DiodeAmplifierAudioProcessor::processBlock (juce::AudioBuffer<float>& buffe
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
     
-    juce::dsp::AudioBlock<float> audioBlock {buffer};
-
-    inputGainProcessor.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
-
-    highPassFilter.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
-
-    preClipFilter.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
+    updateParameters();
+    
+    // Once silence has rung all the way through there's nothing for the chain to do
+    const auto tailSamples = juce::roundToInt(getTailLengthSeconds() * projectSampleRate) + getLatencySamples();
+    const auto idle = silentSamples >= tailSamples;
+    
+    const auto peak = buffer.getMagnitude(0, buffer.getNumSamples());
+    
+    if (peak < (SampleType) 1.0e-8)
+    {
+        if (idle)
+        {
+            // processChain isn't running to report a new oversampling, clipper or cab latency, so it's done here.
+            // Nothing is playing through the cab, it can take a new latency without the dip
+            convolutionProcessor.takeLatestKernel();
+            reportLatency(chain);
+            
+            buffer.clear();
+            return;
+        }
         
-        for (int channel = 0; channel < totalNumInputChannels; ++channel) {
-                auto* inputData = buffer.getReadPointer(channel);
-                auto* outputData = buffer.getWritePointer(channel);
-
-                for (int sample = 0; sample < buffer.getNumSamples(); ++sample) {
+        silentSamples += buffer.getNumSamples();
+    }
+    
+    else
+    {
+        // Start again from silence rather than from whatever the chain held when it stopped
+        if (idle) resetChain(chain);
+        
+        silentSamples = 0;
+    }
+    
+    // The silence check's peak doubles as Auto's level estimate
+    if (oversamplingChoice == autoOversamplingChoice)
+        updateAdaptiveTarget(chain, peak, buffer.getNumSamples());
+    else
+        chain.adaptive.running = false;
+    
+    juce::dsp::AudioBlock<SampleType> audioBlock {buffer};
+    
+    // The settings that change which stages run are fixed for the block, so it goes through
+    // the one instantiation of processChain built for them rather than branching on them
+    static constexpr auto chainVariants = makeChainVariants<SampleType>(std::make_integer_sequence<int, numChainVariants>());
+    
+    const auto variant = (juce::jlimit(0, numOversamplingChoices - 1, oversamplingChoice) * numClipperModes
+                          + juce::jlimit(0, numClipperModes - 1, clipperMode)) * 2 + (convolutionToggle ? 1 : 0);
+    
+    // Every decision is made once for the host block however it's cut up, so the tiles add up to
+    // exactly what the whole block would have been. Filter changes ramp over all of it
+    const auto numSamples = audioBlock.getNumSamples();
+    chain.preClipFilters.beginBlock(numSamples);
+    chain.toneFilters.beginBlock(numSamples);
+    foldedCab.beginBlock(numSamples);
+    chain.adaptive.blockStart = true;
+    
+    // The table is only used once it has caught up with the drive knob, and a ramp runs to the end of the block
+    driveRamping = smoothedDrive.isSmoothing();
+    blockClipperTable = clipperMode > 0 && !driveRamping ? clipperTables.acquire(driveScaled) : nullptr;
+    
+    // Big render blocks go through the whole chain a tile at a time so the intermediates stay in L1
+    for (size_t start = 0; start < numSamples; start += tileSize)
+    {
+        auto tile = audioBlock.getSubBlock(start, juce::jmin(tileSize, numSamples - start));
+        (this->*chainVariants[(size_t) variant])(tile, chain);
+    }
+    
+    blockClipperTable = nullptr;
+    clipperTables.release();
+}
 
-                    float diodeClippingAlgorithm = exp((0.1 * inputData[sample]) / (0.0253 * 1.68)) - 1;
-                    
-                    outputData[sample] = piDivisor * atan(diodeClippingAlgorithm * (driveScaled * 16));
-                }
-            }
+// The chain runs at the host rate apart from the clipper, the only stage that makes new harmonics.
+// It runs at factor times the host rate, between processSamplesUp and processSamplesDown.
+template <typename SampleType, int variant>
+void DiodeAmplifierAudioProcessor::processChain(juce::dsp::AudioBlock<SampleType>& audioBlock, DspChain<SampleType>& chain)
+{
+    // Unpacks the index worked out in processSamples, Auto picks its factor as it goes
+    constexpr auto choice = variant / (numClipperModes * 2);
+    constexpr auto adaptive = choice == autoOversamplingChoice;
+    constexpr auto factor = adaptive ? 1 : 1 << choice;
+    constexpr auto mode = (variant / 2) % numClipperModes;
+    constexpr auto cabOn = variant % 2 == 1;
+    
+    // A gain sitting at 0 dB is a copy, a move away from it ramps in from there as usual
+    const auto getActiveGain = [](juce::SmoothedValue<SampleType>& gain) { return !gain.isSmoothing() && gain.getTargetValue() == (SampleType) 1 ? nullptr : &gain; };
+    
+    // The gains are pointwise, they ride along in the passes the filters make over the block anyway
+    chain.preClipFilters.process(juce::dsp::ProcessContextReplacing<SampleType>(audioBlock), getActiveGain(chain.inputGain), nullptr);
+        
+    if (adaptive)
+    {
+        processAdaptiveClipper<mode>(audioBlock, chain);
+    }
+    
+    else
+    {
+        auto* oversamplingProcessor = getOversamplingProcessor(chain, choice);
+        
+        if (oversamplingProcessor != chain.activeOversamplingProcessor)
+        {
+            // Don't let the newly picked filters ring out whatever they held last time they were used
+            if (oversamplingProcessor != nullptr) oversamplingProcessor->reset();
+            
+            chain.activeOversamplingProcessor = oversamplingProcessor;
+        }
+        
+        updateLatency(factor > 1 ? (double) oversamplingProcessor->getLatencyInSamples() : 0.0, factor);
+        currentOversamplingFactor = factor;
+        
+        processClipperAt<mode>(audioBlock, factor > 1 ? oversamplingProcessor : nullptr, antiderivativeClipper, smoothedDrive);
+    }
 
-    lowFilter.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
+    if (cabOn)
+    {
+        foldedCab.process(audioBlock, foldEq, chain.toneFilters, convolutionProcessor);
+        
+        if (auto* outputGain = getActiveGain(chain.outputGain))
+            audioBlock.multiplyBy(*outputGain);
+    }
+    
+    else
+    {
+        chain.toneFilters.process(juce::dsp::ProcessContextReplacing<SampleType>(audioBlock), nullptr, getActiveGain(chain.outputGain));
+    }
+}
 
-    midFilter.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
+template <typename SampleType>
+void DiodeAmplifierAudioProcessor::resetChain(DspChain<SampleType>& chain)
+{
+    chain.preClipFilters.reset();
+    chain.toneFilters.reset();
+    
+    // Any ramps stalled while the chain was idle, land them where they were headed
+    chain.inputGain.setCurrentAndTargetValue(chain.inputGain.getTargetValue());
+    chain.outputGain.setCurrentAndTargetValue(chain.outputGain.getTargetValue());
+    smoothedDrive.setCurrentAndTargetValue(driveScaled);
+    
+    if (chain.activeOversamplingProcessor != nullptr) chain.activeOversamplingProcessor->reset();
+    
+    // Auto starts over on the factor the level calls for, without a fade
+    chain.adaptive.running = false;
+    
+    antiderivativeClipper.reset();
+    convolutionProcessor.reset();
+    foldedCab.reset();
+}
 
-    highFilter.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
+template <int mode, typename SampleType>
+void DiodeAmplifierAudioProcessor::processClipperAt(juce::dsp::AudioBlock<SampleType>& block, juce::dsp::Oversampling<SampleType>* oversamplingProcessor,
+                                                    AntiderivativeClipper& clipper, SmoothedDrive& drive)
+{
+    if (oversamplingProcessor == nullptr)
+    {
+        processClipper<mode>(block, 1, clipper, drive);
+        return;
+    }
+    
+    auto upsampledBlock = oversamplingProcessor->processSamplesUp(block);
+    processClipper<mode>(upsampledBlock, (int) oversamplingProcessor->getOversamplingFactor(), clipper, drive);
+    oversamplingProcessor->processSamplesDown(block);
+}
 
-    highNotchFilter.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
+template <int mode, typename SampleType>
+void DiodeAmplifierAudioProcessor::processClipper(juce::dsp::AudioBlock<SampleType>& block, int factor, AntiderivativeClipper& clipper, SmoothedDrive& drive)
+{
+    // ADAA history from another mode is meaningless
+    if (mode != lastClipperMode)
+    {
+        antiderivativeClipper.reset();
+        transitionClipper.reset();
+        lastClipperMode = mode;
+    }
+    
+    const auto numSamples = (int) block.getNumSamples();
+    
+    // While the drive is moving the curve gets a value per sample, the tables only know one drive
+    const auto* driveRamp = driveRamping ? drive.getNextBlock(numSamples / factor, factor) : nullptr;
+    auto* clipperTable = mode > 0 ? blockClipperTable : nullptr;
+    
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        auto* data = block.getChannelPointer(channel);
+        
+        // Keep the ADAA history going through the curve so switching back doesn't click
+        if (clipperTable == nullptr && mode >= 2)
+            clipper.skip(data, numSamples, (int) channel);
+        
+        if (driveRamp != nullptr)
+            DiodeClipper::process(data, driveRamp, numSamples);
+        else if (clipperTable == nullptr)
+            DiodeClipper::process(data, numSamples, driveScaled);
+        else if (mode == 1)
+            clipperTable->process(data, numSamples);
+        else
+            clipper.process(*clipperTable, data, numSamples, (int) channel, mode - 1);
+    }
+    
+    if (clipperTable != nullptr) clipper.endBlock(*clipperTable);
+}
 
-    if (convolutionToggle) convolutionProcessor.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
+template <typename SampleType>
+void DiodeAmplifierAudioProcessor::updateAdaptiveTarget(DspChain<SampleType>& chain, SampleType peak, int numSamples)
+{
+    auto& adaptive = chain.adaptive;
+    
+    // How far up the diode curve the block's peak gets, the size of what goes into its atan if the
+    // pre-clip boost lands on it. Below about 0.3 the curve is close enough to straight that 1x doesn't alias
+    const auto inputGain = juce::jmax(chain.inputGain.getCurrentValue(), chain.inputGain.getTargetValue());
+    const auto excursion = (double) peak * inputGain * preClipPeakGain * DiodeClipper::diodeScale * driveScaled * 16.0;
+    
+    // Every factor up takes about 10 dB more excursion
+    auto choice = 0;
+    
+    for (auto threshold = 0.3; choice < autoOversamplingChoice - 1 && excursion > threshold; threshold *= 3.0)
+        ++choice;
+    
+    // Up straight away, down only once the level has stayed down, so every transient isn't a switch
+    if (choice >= adaptive.target)
+    {
+        adaptive.target = choice;
+        adaptive.heldChoice = 0;
+        adaptive.holdSamples = 0;
+        return;
+    }
     
-    outputGainProcessor.process(juce::dsp::ProcessContextReplacing<float>(audioBlock));
+    adaptive.heldChoice = juce::jmax(adaptive.heldChoice, choice);
+    adaptive.holdSamples += numSamples;
+    
+    if (adaptive.holdSamples >= juce::roundToInt(adaptiveHoldSeconds * projectSampleRate))
+    {
+        adaptive.target = adaptive.heldChoice;
+        adaptive.heldChoice = 0;
+        adaptive.holdSamples = 0;
+    }
 }
 
-void DiodeAmplifierAudioProcessor::setAllSampleRates(float value)
+template <int mode, typename SampleType>
+void DiodeAmplifierAudioProcessor::processAdaptiveClipper(juce::dsp::AudioBlock<SampleType>& block, DspChain<SampleType>& chain)
 {
-    *highPassFilter.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(value, 200);
-    *preClipFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(value, 1420, 0.5, 6.0);
-    *lowFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf(value, 200, 1.3, pow(10, *treeState.getRawParameterValue(lowSliderId) * 0.05));
-    *midFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(value, 815, 0.3, pow(10, *treeState.getRawParameterValue(midSliderId) * 0.05));
-    *highFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(value, 6000, 0.2, pow(10, *treeState.getRawParameterValue(highSliderId) * 0.05));
-    *highNotchFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(value, 4000.0f, 1.0f, pow(10.0f, -12.0f / 20.0f) * (*treeState.getRawParameterValue(brightId) + 1));
+    auto& adaptive = chain.adaptive;
+    const auto numSamples = (int) block.getNumSamples();
+    const auto numChannels = block.getNumChannels();
+    
+    // Just switched to Auto, start on whatever the level calls for, like picking it from the menu
+    if (!adaptive.running)
+    {
+        adaptive.alignment.reset();
+        adaptive.choice = adaptive.target;
+        adaptive.incoming = -1;
+        adaptive.running = true;
+    }
+    
+    auto* oversamplingProcessor = getOversamplingProcessor(chain, adaptive.choice);
+    
+    if (oversamplingProcessor != chain.activeOversamplingProcessor)
+    {
+        if (oversamplingProcessor != nullptr) oversamplingProcessor->reset();
+        
+        chain.activeOversamplingProcessor = oversamplingProcessor;
+    }
+    
+    // A new target waits for the switch in progress to finish, and for the next host block
+    if (adaptive.incoming < 0 && adaptive.target != adaptive.choice && adaptive.blockStart)
+    {
+        adaptive.incoming = adaptive.target;
+        adaptive.position = 0;
+    }
+    
+    const auto switching = adaptive.incoming >= 0;
+    auto* incomingProcessor = switching ? getOversamplingProcessor(chain, adaptive.incoming) : nullptr;
+    
+    // The incoming factor warms up from scratch, again if the filter type changes under it
+    if (switching && (adaptive.position == 0 || incomingProcessor != adaptive.incomingProcessor))
+    {
+        if (incomingProcessor != nullptr) incomingProcessor->reset();
+        
+        adaptive.incomingProcessor = incomingProcessor;
+        adaptive.position = 0;
+        transitionClipper.reset();
+    }
+    
+    // Every factor comes out as late as 8x does, the reported latency stays put
+    const auto getLatency = [this, &chain](int choice)
+    {
+        auto* processor = getOversamplingProcessor(chain, choice);
+        return (processor != nullptr ? (double) processor->getLatencyInSamples() : 0.0) + (mode >= 2 ? 0.5 * (mode - 1) / (1 << choice) : 0.0);
+    };
+    
+    auto* maxProcessor = getOversamplingProcessor(chain, autoOversamplingChoice - 1);
+    const auto maxLatency = getLatency(autoOversamplingChoice - 1);
+    updateLatency((double) maxProcessor->getLatencyInSamples(), (int) maxProcessor->getOversamplingFactor());
+    
+    const auto delay = (SampleType) std::round(juce::jmax(0.0, maxLatency - getLatency(adaptive.choice)));
+    const auto incomingDelay = switching ? (SampleType) std::round(juce::jmax(0.0, maxLatency - getLatency(adaptive.incoming))) : (SampleType) 0;
+    
+    auto incomingBlock = juce::dsp::AudioBlock<SampleType>(adaptive.incomingBuffer).getSubsetChannelBlock(0, numChannels).getSubBlock(0, (size_t) numSamples);
+    
+    // The delay line runs the whole time so a lower factor always has its history when it's switched to
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = block.getChannelPointer(channel);
+        auto* incomingData = incomingBlock.getChannelPointer(channel);
+        
+        for (int i = 0; i < numSamples; ++i)
+        {
+            adaptive.alignment.pushSample((int) channel, data[i]);
+            
+            if (switching) incomingData[i] = adaptive.alignment.popSample((int) channel, incomingDelay, false);
+            
+            data[i] = adaptive.alignment.popSample((int) channel, delay);
+        }
+    }
+    
+    // Both clippers start the tile from the same point on the drive ramp
+    if (switching) transitionDrive.follow(smoothedDrive);
+    
+    processClipperAt<mode>(block, oversamplingProcessor, antiderivativeClipper, smoothedDrive);
+    
+    if (switching)
+    {
+        processClipperAt<mode>(incomingBlock, incomingProcessor, transitionClipper, transitionDrive);
+        
+        const auto fadeSamples = juce::jmax(1, juce::roundToInt(adaptiveFadeSeconds * projectSampleRate));
+        const auto fadeStart = fadeSamples - adaptive.position;
+        
+        // Warmed up, now fade over to it
+        if (fadeStart < numSamples)
+        {
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                auto* data = block.getChannelPointer(channel);
+                const auto* incomingData = incomingBlock.getChannelPointer(channel);
+                
+                for (int i = juce::jmax(0, fadeStart); i < numSamples; ++i)
+                {
+                    const auto amount = juce::jmin((SampleType) 1, (SampleType) (i - fadeStart) / (SampleType) fadeSamples);
+                    data[i] += amount * (incomingData[i] - data[i]);
+                }
+            }
+        }
+        
+        adaptive.position += numSamples;
+        
+        // The incoming factor has taken over, its ADAA history is the one that carries on
+        if (adaptive.position >= fadeSamples * 2)
+        {
+            std::swap(antiderivativeClipper, transitionClipper);
+            chain.activeOversamplingProcessor = incomingProcessor;
+            adaptive.choice = adaptive.incoming;
+            adaptive.incoming = -1;
+        }
+    }
+    
+    adaptive.blockStart = false;
+    currentOversamplingFactor = 1 << adaptive.choice;
+}
 
+void DiodeAmplifierAudioProcessor::updateLatency(double oversamplingLatency, int factor)
+{
+    auto latency = oversamplingLatency;
+    
+    // ADAA delays by half a sample (1st order) or a whole one (2nd order) at the clipper's rate
+    if (clipperMode >= 2) latency += 0.5 * (clipperMode - 1) / factor;
+    
+    // The cab only delays anything while it's on, a new cab latency is reported once its switch has dipped to silence
+    if (convolutionToggle.load()) latency += convolutionProcessor.getLatency();
+    
+    if (juce::roundToInt(latency) != getLatencySamples())
+        setLatencySamples(juce::roundToInt(latency));
 }
 
-void DiodeAmplifierAudioProcessor::updateHighPassFilter(const float &freq){
-    *highPassFilter.state = *juce::dsp::IIR::Coefficients<float>::makeHighPass(lastSampleRate, 200);
+template <typename SampleType>
+juce::dsp::Oversampling<SampleType>* DiodeAmplifierAudioProcessor::getOversamplingProcessor(DspChain<SampleType>& chain, int choice)
+{
+    jassert(choice < autoOversamplingChoice);
+    
+    // 1x skips the oversampling stage altogether
+    if (choice == 0) return nullptr;
+    
+    return chain.oversamplingProcessors[oversamplingFilter * 3 + choice - 1].get();
 }
 
-void DiodeAmplifierAudioProcessor::updatePreClipFilter(const float &freq){
-    *preClipFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(lastSampleRate, 1420, 0.5, 6.0);
+void DiodeAmplifierAudioProcessor::updatePreClipFilters()
+{
+    forEachChain([this](auto& chain)
+    {
+        chain.preClipFilters.setCoefficients(highPassFilter, BiquadDesign::makeHighPass(projectSampleRate, 200));
+        chain.preClipFilters.setCoefficients(preClipFilter, BiquadDesign::makePeakFilter(projectSampleRate, 1420, 0.5, preClipPeakGain));
+    });
+    
+    // The tone filters follow their parameters in updateParameters
 }
 
 void DiodeAmplifierAudioProcessor::updateLowFilter(const float &gain){
-    *lowFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf(lastSampleRate, 200, 1.3, pow(10, gain * 0.05));
+    updateToneFilter(lowFilter, BiquadDesign::makeLowShelf(projectSampleRate, 200, 1.3, pow(10, gain * 0.05)));
 }
 
 void DiodeAmplifierAudioProcessor::updateMidFilter(const float &gain){
-    *midFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(lastSampleRate, 815, 0.3, pow(10, gain * 0.05));
+    updateToneFilter(midFilter, BiquadDesign::makePeakFilter(projectSampleRate, 815, 0.3, pow(10, gain * 0.05)));
 }
 
 void DiodeAmplifierAudioProcessor::updateHighFilter(const float &gain){
-    *highFilter.state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(lastSampleRate, 6000, 0.2, pow(10, gain * 0.05));
+    updateToneFilter(highFilter, BiquadDesign::makePeakFilter(projectSampleRate, 6000, 0.2, pow(10, gain * 0.05)));
+}
+
+void DiodeAmplifierAudioProcessor::updateToneFilter(ToneStage stage, const BiquadCoefficients& coefficients)
+{
+    forEachChain([&](auto& chain) { chain.toneFilters.setCoefficients(stage, coefficients); });
+    foldedCab.setToneCoefficients(stage, coefficients);
+}
+
+void DiodeAmplifierAudioProcessor::loadCabImpulse(const juce::File& file)
+{
+    cabLoader.loadFile(file);
+}
+
+void DiodeAmplifierAudioProcessor::resetCabImpulse()
+{
+    cabLoader.loadMemory(BinaryData::metalOne_wav, BinaryData::metalOne_wavSize);
+}
+
+void DiodeAmplifierAudioProcessor::setCabLatency(int choice)
+{
+    cabLoader.setLatency(choice == 0 ? 0 : 128 << choice);
 }
 
 //==============================================================================
@@ -393,6 +807,8 @@ juce::AudioProcessorEditor* DiodeAmplifierAudioProcessor::createEditor()
 //==============================================================================
 void DiodeAmplifierAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
+    if (*treeState.getRawParameterValue(cabId) == 0) variableTree.setProperty("cabOffGain", (double) *treeState.getRawParameterValue(outputGainSliderId), nullptr);
+    
     treeState.state.appendChild(variableTree, nullptr);
 
     juce::MemoryOutputStream stream(destData, false);
@@ -417,21 +833,20 @@ void DiodeAmplifierAudioProcessor::setStateInformation (const void* data, int si
     
     if (savedFile.existsAsFile())
     {
-        convolutionProcessor.loadImpulseResponse(savedFile, juce::dsp::Convolution::Stereo::yes, juce::dsp::Convolution::Trim::yes, 0);
+        loadCabImpulse(savedFile);
         DBG("Location exists as file");
     }
     
     else
     {
-        convolutionProcessor.loadImpulseResponse
-        (BinaryData::metalOne_wav,
-            BinaryData::metalOne_wavSize,
-            juce::dsp::Convolution::Stereo::yes,
-            juce::dsp::Convolution::Trim::yes, 0,
-            juce::dsp::Convolution::Normalise::yes);
+        resetCabImpulse();
     }
     
-    if (!convolutionToggle) treeState.getParameterAsValue(outputGainSliderId) = variableTree.getProperty("cabOffGain");
+    // The saved output gain already goes with the saved cab switch, restoring it isn't a switch to swap for
+    const auto cabOn = *treeState.getRawParameterValue(cabId) != 0;
+    outputGainCabOn.store(cabOn);
+    
+    if (! cabOn && variableTree.hasProperty("cabOffGain")) treeState.getParameterAsValue(outputGainSliderId) = variableTree.getProperty("cabOffGain");
 }
 
 //==============================================================================
@@ -0,0 +1,51 @@
+/* ==================================== JUCER_BINARY_RESOURCE ====================================
+
+   This is an auto-generated file: Any edits you make may be overwritten!
+
+*/
+
+namespace BinaryData
+{
+
+//================== metalOne.wav ==================
+static const unsigned char temp_binary_data_2[] =
+{ 82,73,70,70,230,10,0,0,87,65,86,69,74,85,78,75,28,0,0,0,230,10,0,0,0,0,0,0,186,6,0,0,0,0,0,0,62,2,0,0,0,0,0,0,0,0,0,0,102,109,116,32,16,0,0,0,1,0,1,0,68,172,0,0,204,4,2,0,3,0,24,0,100,97,116,97,186,6,0,0,121,207,255,203,208,255,222,206,255,121,205,255,
+107,198,255,125,196,255,121,192,255,253,191,255,168,176,255,131,125,255,22,31,253,79,239,241,16,71,212,221,208,165,1,0,128,110,96,130,237,105,175,64,231,234,230,39,29,241,136,61,37,140,73,164,245,64,80,169,37,178,2,255,52,116,220,221,210,205,27,227,211,
+40,138,229,249,3,254,16,147,24,26,0,42,12,72,39,102,49,19,186,226,252,204,86,239,230,251,236,9,241,242,181,235,253,180,222,11,115,74,24,90,25,30,78,129,25,33,58,13,178,48,1,166,130,251,65,105,253,30,158,2,41,106,7,253,158,10,37,18,11,214,54,8,157,41,
+3,28,248,255,38,76,1,91,43,4,219,41,6,214,182,8,93,209,12,189,24,15,253,251,12,95,16,10,59,200,9,75,64,10,70,131,7,145,62,2,228,239,254,237,98,255,110,3,2,218,181,3,30,180,3,18,205,3,13,19,5,112,112,7,109,246,10,57,206,14,160,184,15,57,99,12,162,79,7,
+4,148,2,135,179,254,26,39,252,13,169,252,75,232,0,239,120,6,126,181,10,250,37,13,8,240,14,153,152,15,244,15,13,61,203,7,8,148,2,106,57,255,76,128,253,40,129,253,58,139,0,169,180,5,224,13,10,93,74,12,149,48,13,86,48,14,142,236,15,146,181,17,153,17,18,
+110,7,16,137,90,12,166,174,8,65,21,6,196,160,4,141,197,3,51,1,3,170,43,2,194,109,1,215,30,1,180,207,1,209,180,3,1,223,5,158,245,6,212,162,6,55,223,5,176,150,5,184,175,5,86,97,5,235,94,4,110,79,3,15,147,2,159,186,1,197,197,0,107,155,0,113,223,1,171,249,
+3,65,176,5,99,136,6,131,199,6,48,109,6,12,70,5,208,126,3,145,154,1,115,14,0,65,34,255,46,246,254,139,64,255,229,152,255,7,239,255,57,45,0,63,241,255,247,5,255,173,123,253,79,109,251,228,72,249,190,205,247,236,158,247,141,248,248,171,156,251,180,219,254,
+169,227,1,215,36,4,211,89,5,151,114,5,71,156,4,177,32,3,178,48,1,69,252,254,48,229,252,148,133,251,77,131,251,244,63,253,242,128,0,126,66,4,20,52,7,18,153,8,61,137,8,151,107,7,13,185,5,165,42,4,32,82,3,46,27,3,182,9,3,7,189,2,186,12,2,61,206,0,118,7,
+255,140,64,253,21,61,252,227,80,252,212,39,253,191,35,254,10,151,254,166,241,253,73,31,252,137,167,249,204,101,247,34,8,246,223,187,245,207,91,246,217,182,247,94,111,249,238,214,250,29,57,251,192,108,250,155,238,248,248,98,247,53,60,246,100,188,245,159,
+28,246,255,91,247,69,11,249,200,165,250,83,241,251,98,245,252,181,190,253,201,72,254,14,140,254,146,116,254,197,230,253,167,226,252,85,159,251,139,113,250,35,165,249,34,99,249,250,170,249,68,105,250,154,129,251,66,182,252,226,164,253,122,18,254,130,13,
+254,230,199,253,19,99,253,115,222,252,168,66,252,126,182,251,178,112,251,153,128,251,145,174,251,92,195,251,1,184,251,64,175,251,214,235,251,191,152,252,215,133,253,40,49,254,5,37,254,46,73,253,1,4,252,119,5,251,42,198,250,237,69,251,243,57,252,53,71,
+253,242,252,253,167,244,253,145,48,253,122,30,252,26,61,251,98,226,250,229,26,251,69,143,251,104,193,251,100,101,251,104,107,250,213,238,248,224,70,247,160,237,245,132,44,245,130,7,245,3,99,245,123,22,246,106,219,246,222,102,247,48,174,247,186,238,247,
+226,103,248,220,27,249,142,211,249,234,79,250,126,107,250,196,44,250,233,202,249,220,137,249,119,143,249,165,237,249,1,184,250,168,231,251,193,62,253,56,87,254,171,223,254,227,200,254,66,70,254,29,173,253,29,79,253,184,102,253,32,245,253,156,177,254,
+170,50,255,148,49,255,83,186,254,26,20,254,214,142,253,232,100,253,35,168,253,36,53,254,95,186,254,123,243,254,159,211,254,98,100,254,155,168,253,182,171,252,216,150,251,152,177,250,82,57,250,84,60,250,171,167,250,124,100,251,248,77,252,186,44,253,148,
+214,253,84,58,254,168,90,254,211,73,254,34,31,254,26,245,253,70,238,253,52,47,254,58,195,254,69,142,255,5,87,0,233,217,0,151,246,0,221,194,0,213,107,0,217,11,0,233,158,255,144,32,255,3,161,254,67,49,254,47,215,253,30,153,253,232,124,253,243,126,253,30,
+149,253,52,189,253,252,241,253,199,27,254,240,38,254,82,20,254,237,229,253,125,153,253,88,71,253,0,33,253,119,73,253,195,187,253,239,71,254,85,185,254,114,251,254,79,22,255,221,37,255,200,74,255,168,141,255,196,214,255,167,22,0,80,85,0,113,152,0,126,
+224,0,126,35,1,239,91,1,115,143,1,144,197,1,129,255,1,192,42,2,178,56,2,42,56,2,185,66,2,226,101,2,112,170,2,231,24,3,80,155,3,242,251,3,105,15,4,108,213,3,71,124,3,54,61,3,190,54,3,162,103,3,31,181,3,123,245,3,31,6,4,175,197,3,123,34,3,161,63,2,161,
+111,1,233,255,0,23,2,1,238,77,1,158,179,1,124,21,2,174,84,2,188,84,2,54,25,2,3,186,1,169,84,1,32,10,1,87,234,0,130,243,0,18,26,1,156,82,1,245,137,1,161,162,1,244,146,1,254,109,1,55,66,1,34,20,1,207,245,0,101,249,0,143,30,1,149,90,1,229,159,1,127,227,
+1,120,22,2,87,45,2,70,44,2,155,26,2,125,7,2,96,20,2,84,96,2,154,231,2,57,143,3,133,55,4,3,204,4,214,77,5,155,191,5,15,16,6,196,33,6,33,241,5,104,168,5,155,119,5,73,112,5,182,135,5,65,168,5,252,188,5,200,188,5,38,170,5,154,127,5,176,46,5,79,173,4,198,
+253,3,157,57,3,119,144,2,48,34,2,68,232,1,16,215,1,108,242,1,141,58,2,141,159,2,116,3,3,177,65,3,84,61,3,134,248,2,238,146,2,93,48,2,132,237,1,90,223,1,219,0,2,90,38,2,100,28,2,119,224,1,66,163,1,179,139,1,96,150,1,246,167,1,175,180,1,180,215,1,203,50,
+2,1,189,2,158,77,3,94,205,3,174,51,4,99,108,4,252,106,4,108,63,4,119,11,4,66,234,3,108,227,3,23,243,3,48,24,4,85,72,4,158,106,4,173,104,4,96,60,4,235,237,3,126,143,3,133,63,3,136,17,3,208,254,2,235,249,2,122,254,2,118,11,3,84,33,3,155,64,3,113,92,3,165,
+91,3,112,42,3,169,204,2,202,99,2,102,25,2,235,1,2,53,14,2,147,30,2,63,34,2,140,38,2,253,64,2,165,111,2,111,165,2,28,211,2,203,231,2,245,228,2,17,233,2,231,19,3,106,86,3,203,122,3,173,85,3,88,227,2,172,73,2,222,190,1,66,105,1,224,81,1,82,110,1,8,169,1,
+109,232,1,88,23,2,194,41,2,118,28,2,156,238,1,198,156,1,220,34,1,47,141,0,166,0,0,160,163,255,137,135,255,136,171,255,137,255,255,37,101,0,106,187,0,121,234,0,10,227,0,113,165,0,110,73,0,20,252,255,251,221,255,110,238,255,177,28,0,12,86,0,240,136,0,151,
+170,0,13,190,0,44,215,0,125,13,1,0,96,1,6,174,1,216,212,1,36,207,1,243,177,1,40,145,1,134,118,1,218,108,1,207,119,1,130,133,1,79,124,1,200,80,1,80,0,1,94,154,0,57,68,0,108,34,0,95,61,0,144,125,0,82,101,115,85,46,1,0,0,120,156,237,147,75,107,195,48,16,
+132,255,139,174,77,91,43,111,124,11,125,64,161,129,82,82,114,40,193,40,210,58,8,108,41,172,214,166,197,228,191,87,82,92,67,138,105,207,13,57,238,236,183,26,152,65,13,171,1,157,182,134,165,124,192,180,209,164,69,193,210,230,68,70,144,153,164,143,159,178,
+205,115,7,196,210,100,192,84,133,130,162,158,220,36,124,148,240,201,124,54,74,134,126,177,205,72,151,16,33,132,2,106,97,40,115,36,144,122,116,48,170,85,57,92,113,127,93,18,6,177,155,37,66,180,89,125,159,150,86,233,92,203,83,209,137,26,84,55,45,43,167,
+229,61,16,200,0,173,133,123,1,204,45,150,160,226,122,129,40,204,14,86,98,239,214,128,240,230,64,61,153,133,17,197,167,211,46,18,175,224,170,130,252,225,93,112,7,245,136,182,124,182,59,45,87,80,238,237,82,236,127,167,90,131,8,249,215,241,65,105,106,189,
+183,158,244,30,239,13,59,166,40,173,201,89,122,29,162,53,49,89,126,216,12,88,180,233,165,232,184,225,195,36,112,33,185,204,233,157,17,84,33,244,191,219,173,89,202,198,183,99,118,216,28,46,61,158,75,143,151,111,122,214,245,254,131,30,249,116,56,153,241,
+249,148,79,47,133,254,85,232,23,162,255,119,130,99,117,101,32,28,0,0,0,1,0,0,0,1,0,0,0,0,0,0,0,100,97,116,97,0,0,0,0,0,0,0,0,0,0,0,0,76,73,83,84,30,0,0,0,97,100,116,108,108,97,98,108,18,0,0,0,1,0,0,0,84,101,109,112,111,58,32,49,50,48,46,48,0,0,98,101,
+120,116,91,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,32,3,125,8,3,0,0,0,96,193,212,1,0,96,0,0,160,4,125,8,3,0,0,0,1,11,38,32,255,127,0,0,117,13,125,8,3,0,0,0,80,3,125,8,250,255,255,127,8,2,255,255,3,0,0,0,112,13,125,8,3,0,0,0,255,255,255,127,3,0,0,0,180,
+206,254,19,1,0,0,0,16,0,0,1,164,129,1,0,147,222,152,0,0,0,0,0,245,1,0,0,20,0,0,0,0,0,0,0,0,0,0,0,88,127,230,96,0,0,0,0,165,41,38,43,0,0,0,0,88,127,230,96,0,0,0,0,184,3,125,8,3,0,0,0,0,128,182,27,1,0,0,0,0,0,0,0,0,0,0,0,170,0,0,0,0,0,0,0,39,65,22,32,255,
+127,0,0,161,0,32,110,5,0,0,0,0,0,0,0,0,0,0,0,162,171,170,50,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,76,111,103,105,99,32,80,114,111,32,88,0,0,0,0,0,3,5,125,8,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,50,48,50,49,45,48,55,45,48,55,50,51,58,51,48,58,49,54,64,124,118,9,0,0,0,0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,161,0,32,
+110,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 };
+
+const char* metalOne_wav = (const char*) temp_binary_data_2;
+}